@@ -0,0 +1,912 @@
+#include "bitset-atomic.h"
+#include "bitset-compressed.h"
+#include "bitset-dispatch.h"
+#include "bitset-hierarchical.h"
+#include "bitset-id-allocator.h"
+#include "bitset-mmap.h"
+#include "bitset-parallel.h"
+#include "bitset-rank-select.h"
+#include "bitset-static.h"
+#include "bitset.h"
+
+#include <algorithm>
+#include <bitset>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <span>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace {
+
+constexpr std::size_t bits = std::size_t(1) << 27;
+constexpr std::chrono::duration<double> min_time(0.1);
+
+// Parameters of a measurement. A zero size and a negative density are left out of the output.
+struct labels {
+  std::string implementation = "bitset";
+  std::size_t size = 0;
+  std::size_t offset = 0;
+  double density = -1;
+};
+
+struct measurement {
+  std::string section;
+  std::string name;
+  labels params;
+  double ns_per_op;
+  // Negative when the measurement has no byte count.
+  double gb_per_s;
+};
+
+std::string section;
+std::vector<measurement> measurements;
+// Human-readable output, which moves to stderr when stdout carries JSON.
+std::FILE* text = stdout;
+
+void begin_section(std::string name) {
+  std::fprintf(text, "%s:\n", name.c_str());
+  section = std::move(name);
+}
+
+// Average time of a call to `body`, after one warm-up call, over at least `min_time`.
+double seconds_per_call(const std::function<void()>& body) {
+  body();
+  std::size_t calls = 0;
+  std::chrono::duration<double> elapsed(0);
+  auto start = std::chrono::steady_clock::now();
+  for (std::size_t batch = 1; elapsed < min_time; batch *= 2) {
+    for (std::size_t i = 0; i < batch; ++i) {
+      body();
+    }
+    calls += batch;
+    elapsed = std::chrono::steady_clock::now() - start;
+  }
+  return elapsed.count() / double(calls);
+}
+
+void record(std::string_view name, labels params, double bytes, std::size_t ops, const std::function<void()>& body) {
+  double seconds = seconds_per_call(body);
+  measurement result{section, std::string(name), std::move(params), seconds * 1e9 / double(ops), -1};
+  if (bytes >= 0) {
+    result.gb_per_s = bytes / seconds / 1e9;
+  }
+  if (result.params.size != 0) {
+    std::string density = (result.params.density < 0) ? "" : std::to_string(result.params.density).substr(0, 4);
+    std::fprintf(
+        text, "%-16s %-18s %11zu %3zu %5s %12.1f ns %8.2f GB/s\n", result.name.c_str(),
+        result.params.implementation.c_str(), result.params.size, result.params.offset, density.c_str(),
+        result.ns_per_op, result.gb_per_s
+    );
+  } else if (result.gb_per_s >= 0) {
+    std::fprintf(text, "%-24s %8.2f GB/s\n", result.name.c_str(), result.gb_per_s);
+  } else {
+    std::fprintf(text, "%-24s %8.2f ns/op\n", result.name.c_str(), result.ns_per_op);
+  }
+  measurements.push_back(std::move(result));
+}
+
+void report(std::string_view name, std::size_t bytes, const std::function<void()>& body) {
+  record(name, {}, double(bytes), 1, body);
+}
+
+void report_ops(std::string_view name, std::size_t ops, const std::function<void()>& body) {
+  record(name, {}, -1, ops, body);
+}
+
+std::string json_string(std::string_view str) {
+  std::string out = "\"";
+  for (char c : str) {
+    if (c == '"' || c == '\\') {
+      out += '\\';
+    }
+    out += c;
+  }
+  return out + '"';
+}
+
+void write_json() {
+  std::printf("{\n  \"measurements\": [\n");
+  for (std::size_t i = 0; i < measurements.size(); ++i) {
+    const measurement& result = measurements[i];
+    std::printf(
+        "    {\"section\": %s, \"name\": %s, \"implementation\": %s", json_string(result.section).c_str(),
+        json_string(result.name).c_str(), json_string(result.params.implementation).c_str()
+    );
+    if (result.params.size != 0) {
+      std::printf(", \"size\": %zu, \"offset\": %zu", result.params.size, result.params.offset);
+    }
+    if (result.params.density >= 0) {
+      std::printf(", \"density\": %g", result.params.density);
+    }
+    std::printf(", \"ns_per_op\": %.6g", result.ns_per_op);
+    if (result.gb_per_s >= 0) {
+      std::printf(", \"gb_per_s\": %.6g", result.gb_per_s);
+    }
+    std::printf("}%s\n", (i + 1 < measurements.size()) ? "," : "");
+  }
+  std::printf("  ]\n}\n");
+}
+
+void run_rank_select() {
+  constexpr std::size_t size = std::size_t(1) << 24;
+  constexpr std::size_t queries = 1000;
+
+  std::mt19937 rng(1);
+  bitset bs(size, false);
+  std::bernoulli_distribution bit(0.3);
+  for (std::size_t i = 0; i < size; ++i) {
+    bs[i] = bit(rng);
+  }
+  rank_select_index index(bs);
+
+  std::vector<std::size_t> positions(queries);
+  std::vector<std::size_t> ranks(queries);
+  std::uniform_int_distribution<std::size_t> position(0, size);
+  std::uniform_int_distribution<std::size_t> rank(0, index.count() - 1);
+  for (std::size_t i = 0; i < queries; ++i) {
+    positions[i] = position(rng);
+    ranks[i] = rank(rng);
+  }
+
+  report_ops("rank (count)", queries, [&] {
+    std::size_t sum = 0;
+    for (std::size_t pos : positions) {
+      sum += std::as_const(bs).subview(0, pos).count();
+    }
+    [[maybe_unused]] volatile std::size_t result = sum;
+  });
+  report_ops("rank (index)", queries, [&] {
+    std::size_t sum = 0;
+    for (std::size_t pos : positions) {
+      sum += index.rank1(pos);
+    }
+    [[maybe_unused]] volatile std::size_t result = sum;
+  });
+  report_ops("select (index)", queries, [&] {
+    std::size_t sum = 0;
+    for (std::size_t k : ranks) {
+      sum += index.select1(k);
+    }
+    [[maybe_unused]] volatile std::size_t result = sum;
+  });
+}
+
+void run_compressed() {
+  std::mt19937 rng(2);
+  bitset lhs(bits, false);
+  bitset rhs(bits, false);
+  std::uniform_int_distribution<std::size_t> position(0, bits - 1);
+  for (std::size_t i = 0; i < bits / 1000; ++i) {
+    lhs[position(rng)] = true;
+    rhs[position(rng)] = true;
+  }
+  rhs.subview(bits / 4, bits / 4).set();
+  compressed_bitset compressed_lhs(lhs);
+  compressed_bitset compressed_rhs(rhs);
+  const std::size_t bytes = bits / 8;
+
+  std::size_t memory = compressed_lhs.memory_usage() + compressed_rhs.memory_usage();
+  std::fprintf(text, "memory: %zu bytes (bitset %zu)\n", memory, bytes * 2);
+  report("& (bitset)", bytes * 2, [&] { [[maybe_unused]] volatile std::size_t count = bitset(lhs & rhs).count(); });
+  report("& (compressed)", bytes * 2, [&] {
+    [[maybe_unused]] volatile std::size_t count = (compressed_lhs & compressed_rhs).count();
+  });
+  report("| (compressed)", bytes * 2, [&] {
+    [[maybe_unused]] volatile std::size_t count = (compressed_lhs | compressed_rhs).count();
+  });
+  report("compress", bytes, [&] { [[maybe_unused]] volatile std::size_t count = compressed_bitset(lhs).count(); });
+}
+
+void run_parallel() {
+  bitset_executor executor;
+  bitset lhs(bits, false);
+  const bitset rhs(bits, true);
+  const std::size_t bytes = bits / 8;
+
+  std::fprintf(text, "threads: %zu\n", executor.concurrency());
+  report("&= (parallel)", bytes * 2, [&] { executor.and_assign(lhs, rhs); });
+  report("^= (parallel)", bytes * 2, [&] { executor.xor_assign(lhs, rhs); });
+  report("count (parallel)", bytes, [&] { [[maybe_unused]] volatile std::size_t count = executor.count(lhs); });
+  report("== (parallel)", bytes * 2, [&] { [[maybe_unused]] volatile bool equal = executor.equal(lhs, rhs); });
+}
+
+// Each thread claims and releases `ops` pseudo-random bits of a shared 4096-bit set, either through
+// `atomic_bitset` or through a `bitset` guarded by a mutex.
+void run_atomic() {
+  constexpr std::size_t size = 4096;
+  constexpr std::size_t ops = 1 << 20;
+
+  for (std::size_t threads : {std::size_t(1), std::size_t(4)}) {
+    std::string suffix = threads == 1 ? " (1 thread)" : " (4 threads)";
+    auto run_threads = [threads](const std::function<void(std::size_t)>& body) {
+      std::vector<std::thread> workers;
+      for (std::size_t t = 0; t < threads; ++t) {
+        workers.emplace_back(body, t);
+      }
+      for (std::thread& worker : workers) {
+        worker.join();
+      }
+    };
+
+    atomic_bitset shared(size);
+    report_ops("atomic" + suffix, ops * threads, [&] {
+      run_threads([&shared](std::size_t t) {
+        for (std::size_t i = 0; i < ops; ++i) {
+          std::size_t index = (i * 2654435761u + t) % size;
+          if (!shared.test_and_set(index, std::memory_order_acquire)) {
+            shared.reset(index, std::memory_order_release);
+          }
+        }
+      });
+    });
+
+    bitset guarded(size, false);
+    std::mutex mutex;
+    report_ops("mutex" + suffix, ops * threads, [&] {
+      run_threads([&guarded, &mutex](std::size_t t) {
+        for (std::size_t i = 0; i < ops; ++i) {
+          std::size_t index = (i * 2654435761u + t) % size;
+          std::lock_guard lock(mutex);
+          if (!guarded[index]) {
+            guarded[index] = true;
+            guarded[index] = false;
+          }
+        }
+      });
+    });
+  }
+}
+
+// Acquire and release cycles on a 1M-id allocator that is 90% full, against `find_first_zero` on a bitset.
+void run_id_allocator() {
+  constexpr std::size_t capacity = std::size_t(1) << 20;
+  constexpr std::size_t ops = 1 << 18;
+
+  bitset used(capacity, false);
+  used.subview(0, capacity / 10 * 9).set();
+  report_ops("find_first_zero scan", ops / 64, [&] {
+    for (std::size_t i = 0; i < ops / 64; ++i) {
+      std::size_t id = used.find_first_zero();
+      used[id] = true;
+      used[id] = false;
+    }
+  });
+
+  for (std::size_t threads : {std::size_t(1), std::size_t(4)}) {
+    id_allocator allocator(capacity);
+    for (std::size_t i = 0; i < capacity / 10 * 9; ++i) {
+      allocator.acquire();
+    }
+    std::string suffix = threads == 1 ? " (1 thread)" : " (4 threads)";
+    report_ops("id_allocator" + suffix, ops * threads, [&] {
+      std::vector<std::thread> workers;
+      for (std::size_t t = 0; t < threads; ++t) {
+        workers.emplace_back([&allocator] {
+          std::vector<std::size_t> held(16);
+          for (std::size_t i = 0; i < ops; i += held.size()) {
+            for (std::size_t& id : held) {
+              id = allocator.acquire();
+            }
+            for (std::size_t id : held) {
+              allocator.release(id);
+            }
+          }
+        });
+      }
+      for (std::thread& worker : workers) {
+        worker.join();
+      }
+    });
+  }
+}
+
+// Walks the 1000 set bits of a 128M-bit bitset with `find_next`.
+void run_hierarchical() {
+  std::mt19937 rng(3);
+  std::uniform_int_distribution<std::size_t> position(0, bits - 1);
+  bitset plain(bits, false);
+  for (std::size_t i = 0; i < 1000; ++i) {
+    plain[position(rng)] = true;
+  }
+  hierarchical_bitset hierarchical(plain);
+
+  report_ops("find_next (bitset)", plain.count(), [&] {
+    std::size_t sum = 0;
+    for (std::size_t pos = plain.find_first(); pos != bitset::npos; pos = plain.find_next(pos)) {
+      sum += pos;
+    }
+    [[maybe_unused]] volatile std::size_t result = sum;
+  });
+  report_ops("find_next (hierarchical)", plain.count(), [&] {
+    std::size_t sum = 0;
+    for (std::size_t pos = hierarchical.find_first(); pos != bitset::npos; pos = hierarchical.find_next(pos)) {
+      sum += pos;
+    }
+    [[maybe_unused]] volatile std::size_t result = sum;
+  });
+  report_ops("set/reset (hierarchical)", 2, [&] {
+    hierarchical.set(12345);
+    hierarchical.reset(12345);
+  });
+}
+
+void run_serialization() {
+  bitset bs(bits, false);
+  for (std::size_t i = 0; i < bits; i += 7) {
+    bs[i] = true;
+  }
+  const std::size_t bytes = bits / 8;
+
+  std::stringstream stream;
+  report("write", bytes, [&] {
+    stream.str({});
+    bs.write(stream);
+  });
+  std::string data = stream.str();
+  report("read", bytes, [&] {
+    std::istringstream in(data);
+    [[maybe_unused]] volatile std::size_t size = bitset::read(in).size();
+  });
+  std::vector<uint64_t> buffer(data.size() / sizeof(uint64_t));
+  std::memcpy(buffer.data(), data.data(), data.size());
+  report("from_buffer (verified)", bytes, [&] {
+    [[maybe_unused]] volatile std::size_t size = bitset::from_buffer(std::as_bytes(std::span(buffer)))->size();
+  });
+
+  std::string path = (std::filesystem::temp_directory_path() / "bitset-bench.bin").string();
+  {
+    std::ofstream out(path, std::ios::binary);
+    bs.write(out);
+  }
+  report_ops("mmap open", 1, [&] {
+    mmap_bitset mapped;
+    mapped.open(path);
+  });
+  mmap_bitset mapped;
+  mapped.open(path);
+  report("count (mmap)", bytes, [&] { [[maybe_unused]] volatile std::size_t count = mapped.view().count(); });
+  mapped.close();
+  std::filesystem::remove(path);
+}
+
+void run_text() {
+  const std::size_t size = bits / 16;
+  std::mt19937_64 rng(29);
+  bitset bs(size, false);
+  for (std::size_t i = 0; i < size; ++i) {
+    bs[i] = (rng() & 1) != 0;
+  }
+
+  std::string str;
+  report("to_string", size, [&] { str = to_string(bs); });
+  report("to_string (per bit)", size, [&] {
+    std::string slow;
+    for (std::size_t i = 0; i < size; ++i) {
+      slow += bs[i] ? '1' : '0';
+    }
+    [[maybe_unused]] volatile std::size_t length = slow.size();
+  });
+  report("bitset(string_view)", size, [&] { [[maybe_unused]] volatile std::size_t n = bitset(str).size(); });
+  report("from_string", size, [&] { [[maybe_unused]] volatile std::size_t n = from_string(str)->size(); });
+  report("operator<<", size, [&] {
+    std::ostringstream out;
+    out << bs;
+  });
+
+  std::string hex = to_hex(bs);
+  report("to_hex", hex.size(), [&] { hex = to_hex(bs); });
+  report("from_hex", hex.size(), [&] { [[maybe_unused]] volatile std::size_t n = from_hex(hex)->size(); });
+  std::string base64 = to_base64(bs);
+  report("to_base64", base64.size(), [&] { base64 = to_base64(bs); });
+  report("from_base64", base64.size(), [&] {
+    [[maybe_unused]] volatile std::size_t n = from_base64(base64)->size();
+  });
+}
+
+void run_all() {
+  bitset lhs(bits + bitset::word_size, false);
+  bitset rhs(bits + bitset::word_size, true);
+  const bitset same(rhs);
+  const std::size_t bytes = bits / 8;
+
+  for (std::size_t rhs_offset : {std::size_t(0), std::size_t(13)}) {
+    bitset::view dst = lhs.subview(0, bits);
+    bitset::const_view src = std::as_const(rhs).subview(rhs_offset, bits);
+    std::string suffix = rhs_offset == 0 ? " (aligned)" : " (shifted)";
+
+    report("&=" + suffix, bytes * 2, [&] { dst &= src; });
+    report("|=" + suffix, bytes * 2, [&] { dst |= src; });
+    report("^=" + suffix, bytes * 2, [&] { dst ^= src; });
+    bitset::const_view other = same.subview(0, bits);
+    report("==" + suffix, bytes * 2, [&] { [[maybe_unused]] volatile bool equal = (src == other); });
+  }
+
+  report("append (shifted)", bytes, [&] {
+    bitset built;
+    for (std::size_t i = 0; i < bits; i += 4093) {
+      built.append(std::as_const(rhs).subview(13, std::min<std::size_t>(4093, bits - i)));
+    }
+  });
+  report_ops("push_back", bits / 64, [&] {
+    bitset built;
+    for (std::size_t i = 0; i < bits / 64; ++i) {
+      built.push_back(i % 3 == 0);
+    }
+  });
+
+  bitset::view dst = lhs.subview(0, bits);
+  report("flip", bytes, [&] { dst.flip(); });
+  report("set", bytes, [&] { dst.set(); });
+  report("reset", bytes, [&] { dst.reset(); });
+  report("count", bytes, [&] { [[maybe_unused]] volatile std::size_t count = dst.count(); });
+  report("any", bytes, [&] { [[maybe_unused]] volatile bool any = dst.any(); });
+
+  dst.reset();
+  lhs[bits - 1] = true;
+  report("find_first", bytes, [&] { [[maybe_unused]] volatile std::size_t pos = dst.find_first(); });
+  lhs[bits - 1] = false;
+  lhs[0] = true;
+  report("find_last", bytes, [&] { [[maybe_unused]] volatile std::size_t pos = dst.find_last(); });
+
+  for (std::size_t i = 0; i < bits; i += 97) {
+    lhs[i] = true;
+  }
+  report("iterate bits (1%)", bytes, [&] {
+    std::size_t sum = 0;
+    std::size_t index = 0;
+    for (bool bit : dst) {
+      sum += bit ? index : 0;
+      ++index;
+    }
+    [[maybe_unused]] volatile std::size_t result = sum;
+  });
+  report("ones (1%)", bytes, [&] {
+    std::size_t sum = 0;
+    for (std::size_t index : dst.ones()) {
+      sum += index;
+    }
+    [[maybe_unused]] volatile std::size_t result = sum;
+  });
+  report("for_each_set_bit (1%)", bytes, [&] {
+    std::size_t sum = 0;
+    for_each_set_bit(dst, [&sum](std::size_t index) { sum += index; });
+    [[maybe_unused]] volatile std::size_t result = sum;
+  });
+}
+
+// A 256-bit set of flags, as `static_bitset` and as `bitset`.
+void run_static() {
+  constexpr std::size_t size = 256;
+  constexpr std::size_t ops = 1 << 16;
+  static_bitset<size> fixed_lhs;
+  static_bitset<size> fixed_rhs;
+  bitset lhs(size, false);
+  bitset rhs(size, false);
+  for (std::size_t i = 0; i < size; i += 5) {
+    fixed_rhs.set(i);
+    rhs[i] = true;
+  }
+
+  report_ops("construct (static)", ops, [&] {
+    for (std::size_t i = 0; i < ops; ++i) {
+      [[maybe_unused]] volatile bool any = static_bitset<size>().set(i % size).any();
+    }
+  });
+  report_ops("construct (bitset)", ops, [&] {
+    for (std::size_t i = 0; i < ops; ++i) {
+      bitset bs(size, false);
+      bs[i % size] = true;
+      [[maybe_unused]] volatile bool any = bs.any();
+    }
+  });
+  report_ops("|= count (static)", ops, [&] {
+    std::size_t sum = 0;
+    for (std::size_t i = 0; i < ops; ++i) {
+      fixed_lhs.flip(i % size);
+      sum += (fixed_lhs |= fixed_rhs).count();
+    }
+    [[maybe_unused]] volatile std::size_t result = sum;
+  });
+  report_ops("|= count (bitset)", ops, [&] {
+    std::size_t sum = 0;
+    for (std::size_t i = 0; i < ops; ++i) {
+      lhs[i % size].flip();
+      sum += (lhs |= rhs).count();
+    }
+    [[maybe_unused]] volatile std::size_t result = sum;
+  });
+}
+
+// Sizes from one bit up to `max_bits`, growing 16 times per step past the first word sizes.
+std::vector<std::size_t> suite_sizes(std::size_t max_bits) {
+  std::vector<std::size_t> sizes;
+  for (std::size_t size : {std::size_t(1), std::size_t(64), std::size_t(1000)}) {
+    if (size <= max_bits) {
+      sizes.push_back(size);
+    }
+  }
+  for (std::size_t size = 4096; size <= max_bits; size *= 16) {
+    sizes.push_back(size);
+  }
+  if (sizes.back() != max_bits) {
+    sizes.push_back(max_bits);
+  }
+  return sizes;
+}
+
+// `size` bits, each set with probability `density`.
+bitset random_bitset(std::size_t size, double density, std::mt19937_64& rng) {
+  if (density == 0.5) {
+    bitset bs;
+    bs.reserve(size);
+    for (std::size_t i = 0; i < size; i += bitset::word_size) {
+      bs.append_word(rng(), std::min(bitset::word_size, size - i));
+    }
+    return bs;
+  }
+  bitset bs(size, density >= 1);
+  if (density > 0 && density < 1) {
+    std::uniform_int_distribution<std::size_t> position(0, size - 1);
+    for (std::size_t i = 0; i < std::size_t(double(size) * density); ++i) {
+      bs[position(rng)] = true;
+    }
+  }
+  return bs;
+}
+
+// Every operation on views of each size, starting at a word boundary and 13 bits past it. The right-hand sides
+// are aligned, so the misaligned views also exercise the shifted kernels.
+void run_suite(const std::vector<std::size_t>& sizes) {
+  std::mt19937_64 rng(5);
+  for (std::size_t size : sizes) {
+    const double bytes = double(size) / 8;
+    for (std::size_t offset : {std::size_t(0), std::size_t(13)}) {
+      labels params{"bitset", size, offset, 0.5};
+      bitset lhs = random_bitset(size + offset, 0.5, rng);
+      const bitset rhs = random_bitset(size, 0.5, rng);
+      bitset::view dst = lhs.subview(offset, size);
+      bitset::const_view src = std::as_const(lhs).subview(offset, size);
+
+      record("construct", params, bytes, 1, [&] {
+        [[maybe_unused]] volatile std::size_t n = bitset(size, false).size();
+      });
+      record("copy", params, bytes * 2, 1, [&] { [[maybe_unused]] volatile std::size_t n = bitset(src).size(); });
+      record("<< 13", params, bytes * 2, 1, [&] { [[maybe_unused]] volatile std::size_t n = (src << 13).size(); });
+      record("to_string", params, bytes, 1, [&] { [[maybe_unused]] volatile std::size_t n = to_string(src).size(); });
+      record("&=", params, bytes * 2, 1, [&] { dst &= rhs; });
+      record("|=", params, bytes * 2, 1, [&] { dst |= rhs; });
+      record("^=", params, bytes * 2, 1, [&] { dst ^= rhs; });
+      record("flip", params, bytes, 1, [&] { dst.flip(); });
+      record("set", params, bytes, 1, [&] { dst.set(); });
+      record("reset", params, bytes, 1, [&] { dst.reset(); });
+    }
+
+    for (double density : {0.0, 0.01, 0.5, 1.0}) {
+      for (std::size_t offset : {std::size_t(0), std::size_t(13)}) {
+        labels params{"bitset", size, offset, density};
+        const bitset data = random_bitset(size + offset, density, rng);
+        bitset::const_view view = data.subview(offset, size);
+        const bitset same(view);
+
+        record("count", params, bytes, 1, [&] { [[maybe_unused]] volatile std::size_t n = view.count(); });
+        record("all", params, bytes, 1, [&] { [[maybe_unused]] volatile bool all = view.all(); });
+        record("any", params, bytes, 1, [&] { [[maybe_unused]] volatile bool any = view.any(); });
+        record("==", params, bytes * 2, 1, [&] { [[maybe_unused]] volatile bool equal = (view == same); });
+        record("find_first", params, bytes, 1, [&] {
+          [[maybe_unused]] volatile std::size_t pos = view.find_first();
+        });
+        record("iterate", params, bytes, 1, [&] {
+          std::size_t sum = 0;
+          for (bool bit : view) {
+            sum += bit;
+          }
+          [[maybe_unused]] volatile std::size_t result = sum;
+        });
+        record("ones", params, bytes, 1, [&] {
+          std::size_t sum = 0;
+          for (std::size_t index : view.ones()) {
+            sum += index;
+          }
+          [[maybe_unused]] volatile std::size_t result = sum;
+        });
+      }
+    }
+  }
+}
+
+// `size` random bits in words of type `W`.
+template <typename W>
+basic_bitset<W> random_words(std::size_t size, std::mt19937_64& rng) {
+  basic_bitset<W> bs;
+  bs.reserve(size);
+  for (std::size_t i = 0; i < size; i += basic_bitset<W>::word_size) {
+    W word = W(rng());
+    if constexpr (basic_bitset<W>::word_size > 64) {
+      word = (word << 64) | W(rng());
+    }
+    bs.append_word(word, std::min(basic_bitset<W>::word_size, size - i));
+  }
+  return bs;
+}
+
+// The word-level operations of the suite with 32-, 64- and 128-bit words.
+template <typename W>
+void run_word_size(const std::vector<std::size_t>& sizes, const std::string& implementation) {
+  std::mt19937_64 rng(7);
+  for (std::size_t size : sizes) {
+    const double bytes = double(size) / 8;
+    for (std::size_t offset : {std::size_t(0), std::size_t(13)}) {
+      labels params{implementation, size, offset, 0.5};
+      basic_bitset<W> lhs = random_words<W>(size + offset, rng);
+      const basic_bitset<W> rhs = random_words<W>(size, rng);
+      const basic_bitset<W> empty(size + offset, false);
+      typename basic_bitset<W>::view dst = lhs.subview(offset, size);
+      typename basic_bitset<W>::const_view src = std::as_const(lhs).subview(offset, size);
+      typename basic_bitset<W>::const_view zeros = empty.subview(offset, size);
+      const basic_bitset<W> same(src);
+
+      record("count", params, bytes, 1, [&] { [[maybe_unused]] volatile std::size_t n = src.count(); });
+      record("==", params, bytes * 2, 1, [&] { [[maybe_unused]] volatile bool equal = (src == same); });
+      record("find_first", params, bytes, 1, [&] {
+        [[maybe_unused]] volatile std::size_t pos = zeros.find_first();
+      });
+      record("to_string", params, bytes, 1, [&] { [[maybe_unused]] volatile std::size_t n = to_string(src).size(); });
+      record("&=", params, bytes * 2, 1, [&] { dst &= rhs; });
+      record("^=", params, bytes * 2, 1, [&] { dst ^= rhs; });
+      record("flip", params, bytes, 1, [&] { dst.flip(); });
+    }
+  }
+}
+
+// Popcount reductions of two views: fused, through a lazy expression, and through a temporary bitset.
+void run_similarity(const std::vector<std::size_t>& sizes) {
+  std::mt19937_64 rng(8);
+  for (std::size_t size : sizes) {
+    const double bytes = double(size) / 8 * 2;
+    for (std::size_t offset : {std::size_t(0), std::size_t(13)}) {
+      const bitset lhs = random_bitset(size + offset, 0.5, rng);
+      const bitset rhs = random_bitset(size, 0.5, rng);
+      bitset::const_view a = lhs.subview(offset, size);
+      bitset::const_view b = rhs.subview();
+
+      record("xor_count", {"fused", size, offset, 0.5}, bytes, 1, [&] {
+        [[maybe_unused]] volatile std::size_t n = a.xor_count(b);
+      });
+      record("xor_count", {"expression", size, offset, 0.5}, bytes, 1, [&] {
+        [[maybe_unused]] volatile std::size_t n = (a ^ b).count();
+      });
+      record("xor_count", {"materialized", size, offset, 0.5}, bytes, 1, [&] {
+        [[maybe_unused]] volatile std::size_t n = bitset(a ^ b).count();
+      });
+      record("and_count", {"fused", size, offset, 0.5}, bytes, 1, [&] {
+        [[maybe_unused]] volatile std::size_t n = a.and_count(b);
+      });
+      record("and_count", {"expression", size, offset, 0.5}, bytes, 1, [&] {
+        [[maybe_unused]] volatile std::size_t n = (a & b).count();
+      });
+      record("jaccard", {"fused", size, offset, 0.5}, bytes * 2, 1, [&] {
+        [[maybe_unused]] volatile double j = jaccard(a, b);
+      });
+      // A view is a subset of itself, so this scans every word.
+      record("is_subset_of", {"fused", size, offset, 0.5}, bytes, 1, [&] {
+        [[maybe_unused]] volatile bool subset = a.is_subset_of(a);
+      });
+    }
+  }
+}
+
+// The suite operations written the usual way for `std::vector<bool>`, which has no bitwise operators.
+void run_vector_bool(const std::vector<std::size_t>& sizes) {
+  std::mt19937_64 rng(6);
+  for (std::size_t size : sizes) {
+    const double bytes = double(size) / 8;
+    labels params{"std::vector<bool>", size, 0, 0.5};
+    std::vector<bool> lhs(size);
+    std::vector<bool> rhs(size);
+    for (std::size_t i = 0; i < size; ++i) {
+      lhs[i] = (rng() & 1) != 0;
+      rhs[i] = (rng() & 1) != 0;
+    }
+    const std::vector<bool> same(lhs);
+
+    record("construct", params, bytes, 1, [&] {
+      [[maybe_unused]] volatile std::size_t n = std::vector<bool>(size).size();
+    });
+    record("copy", params, bytes * 2, 1, [&] {
+      [[maybe_unused]] volatile std::size_t n = std::vector<bool>(lhs).size();
+    });
+    record("<< 13", params, bytes * 2, 1, [&] {
+      std::vector<bool> shifted(lhs);
+      shifted.resize(size + 13);
+      [[maybe_unused]] volatile std::size_t n = shifted.size();
+    });
+    record("to_string", params, bytes, 1, [&] {
+      std::string str(size, '0');
+      for (std::size_t i = 0; i < size; ++i) {
+        str[i] = lhs[i] ? '1' : '0';
+      }
+      [[maybe_unused]] volatile std::size_t n = str.size();
+    });
+    record("count", params, bytes, 1, [&] {
+      [[maybe_unused]] volatile std::size_t n = std::count(lhs.begin(), lhs.end(), true);
+    });
+    record("all", params, bytes, 1, [&] {
+      [[maybe_unused]] volatile bool all = std::find(lhs.begin(), lhs.end(), false) == lhs.end();
+    });
+    record("any", params, bytes, 1, [&] {
+      [[maybe_unused]] volatile bool any = std::find(lhs.begin(), lhs.end(), true) != lhs.end();
+    });
+    record("==", params, bytes * 2, 1, [&] { [[maybe_unused]] volatile bool equal = (lhs == same); });
+    record("iterate", params, bytes, 1, [&] {
+      std::size_t sum = 0;
+      for (bool bit : lhs) {
+        sum += bit;
+      }
+      [[maybe_unused]] volatile std::size_t result = sum;
+    });
+    record("&=", params, bytes * 2, 1, [&] {
+      for (std::size_t i = 0; i < size; ++i) {
+        lhs[i] = lhs[i] && rhs[i];
+      }
+    });
+    record("|=", params, bytes * 2, 1, [&] {
+      for (std::size_t i = 0; i < size; ++i) {
+        lhs[i] = lhs[i] || rhs[i];
+      }
+    });
+    record("^=", params, bytes * 2, 1, [&] {
+      for (std::size_t i = 0; i < size; ++i) {
+        lhs[i] = lhs[i] != rhs[i];
+      }
+    });
+    record("flip", params, bytes, 1, [&] { lhs.flip(); });
+    record("set", params, bytes, 1, [&] { std::fill(lhs.begin(), lhs.end(), true); });
+    record("reset", params, bytes, 1, [&] { std::fill(lhs.begin(), lhs.end(), false); });
+  }
+}
+
+template <std::size_t Size>
+void run_std_bitset() {
+  constexpr double bytes = double(Size) / 8;
+  labels params{"std::bitset", Size, 0, 0.5};
+  std::mt19937_64 rng(7);
+  auto lhs = std::make_unique<std::bitset<Size>>();
+  auto rhs = std::make_unique<std::bitset<Size>>();
+  for (std::size_t i = 0; i < Size; ++i) {
+    (*lhs)[i] = (rng() & 1) != 0;
+    (*rhs)[i] = (rng() & 1) != 0;
+  }
+  const auto same = std::make_unique<std::bitset<Size>>(*lhs);
+
+  record("construct", params, bytes, 1, [&] {
+    [[maybe_unused]] volatile std::size_t n = std::make_unique<std::bitset<Size>>()->size();
+  });
+  record("copy", params, bytes * 2, 1, [&] {
+    [[maybe_unused]] volatile std::size_t n = std::make_unique<std::bitset<Size>>(*lhs)->size();
+  });
+  record("<< 13", params, bytes * 2, 1, [&] {
+    [[maybe_unused]] volatile std::size_t n = std::make_unique<std::bitset<Size>>(*lhs << 13)->size();
+  });
+  record("to_string", params, bytes, 1, [&] { [[maybe_unused]] volatile std::size_t n = lhs->to_string().size(); });
+  record("count", params, bytes, 1, [&] { [[maybe_unused]] volatile std::size_t n = lhs->count(); });
+  record("all", params, bytes, 1, [&] { [[maybe_unused]] volatile bool all = lhs->all(); });
+  record("any", params, bytes, 1, [&] { [[maybe_unused]] volatile bool any = lhs->any(); });
+  record("==", params, bytes * 2, 1, [&] { [[maybe_unused]] volatile bool equal = (*lhs == *same); });
+  record("iterate", params, bytes, 1, [&] {
+    std::size_t sum = 0;
+    for (std::size_t i = 0; i < Size; ++i) {
+      sum += (*lhs)[i];
+    }
+    [[maybe_unused]] volatile std::size_t result = sum;
+  });
+  record("&=", params, bytes * 2, 1, [&] { *lhs &= *rhs; });
+  record("|=", params, bytes * 2, 1, [&] { *lhs |= *rhs; });
+  record("^=", params, bytes * 2, 1, [&] { *lhs ^= *rhs; });
+  record("flip", params, bytes, 1, [&] { lhs->flip(); });
+  record("set", params, bytes, 1, [&] { lhs->set(); });
+  record("reset", params, bytes, 1, [&] { lhs->reset(); });
+}
+
+} // namespace
+
+// Usage: bitset-bench [--json] [--max-bits N] [--section NAME]...
+//
+// `--max-bits` bounds the sizes of the suite (8589934592 for 1 GiB); `--section` runs only the named sections.
+// With `--json`, stdout carries the measurements and the progress lines go to stderr.
+int main(int argc, char** argv) {
+  bool json = false;
+  std::size_t max_bits = bits;
+  std::vector<std::string> only;
+  for (int i = 1; i < argc; ++i) {
+    std::string_view arg = argv[i];
+    if (arg == "--json") {
+      json = true;
+    } else if (arg == "--max-bits" && i + 1 < argc) {
+      max_bits = std::max<std::size_t>(1, std::strtoull(argv[++i], nullptr, 10));
+    } else if (arg == "--section" && i + 1 < argc) {
+      only.emplace_back(argv[++i]);
+    } else {
+      std::fprintf(stderr, "usage: %s [--json] [--max-bits N] [--section NAME]...\n", argv[0]);
+      return 2;
+    }
+  }
+  if (json) {
+    text = stderr;
+  }
+
+  // The per-bit loops of the comparisons are too slow for the largest sizes.
+  std::vector<std::size_t> sizes = suite_sizes(max_bits);
+  std::vector<std::size_t> compared_sizes;
+  std::copy_if(sizes.begin(), sizes.end(), std::back_inserter(compared_sizes), [](std::size_t size) {
+    return size <= bits;
+  });
+
+  const std::vector<std::pair<std::string, std::function<void()>>> sections = {
+      {"kernels",
+       [] {
+         for (auto backend : {
+                  bitset_simd::backend::scalar,
+                  bitset_simd::backend::simd128,
+                  bitset_simd::backend::avx2,
+                  bitset_simd::backend::avx512,
+              }) {
+           if (bitset_simd::select_backend(backend)) {
+             begin_section("kernels (" + std::string(bitset_simd::to_string(backend)) + ")");
+             run_all();
+           }
+         }
+         bitset_simd::select_backend(bitset_simd::best_backend());
+       }},
+      {"suite", [&] { run_suite(sizes); }},
+      {"word sizes",
+       [&] {
+         run_word_size<uint32_t>(sizes, "bitset32");
+         run_word_size<uint64_t>(sizes, "bitset");
+         run_word_size<bitset_word::uint128>(sizes, "bitset128");
+       }},
+      {"similarity", [&] { run_similarity(sizes); }},
+      {"std::vector<bool>", [&] { run_vector_bool(compared_sizes); }},
+      {"std::bitset",
+       [&] {
+         run_std_bitset<64>();
+         run_std_bitset<4096>();
+         run_std_bitset<(std::size_t(1) << 20)>();
+       }},
+      {"static_bitset", run_static},
+      {"rank/select", run_rank_select},
+      {"atomic", run_atomic},
+      {"text", run_text},
+      {"serialization", run_serialization},
+      {"hierarchical", run_hierarchical},
+      {"id allocator", run_id_allocator},
+      {"parallel", run_parallel},
+      {"compressed", run_compressed},
+  };
+  for (const auto& [name, run] : sections) {
+    if (only.empty() || std::find(only.begin(), only.end(), name) != only.end()) {
+      if (name != "kernels") {
+        begin_section(name);
+      }
+      run();
+    }
+  }
+
+  if (json) {
+    write_json();
+  }
+}
@@ -0,0 +1,100 @@
+#include "bitset-atomic.h"
+
+#include <algorithm>
+#include <bit>
+
+atomic_bitset::atomic_bitset(std::size_t size, bool value)
+    : _words((size + word_size - 1) / word_size, value ? ~word_type(0) : 0)
+    , _size(size) {}
+
+atomic_bitset::atomic_bitset(const bitset::const_view& view)
+    : _words((view.size() + word_size - 1) / word_size)
+    , _size(view.size()) {
+  for_each_set_bit(view, [this](std::size_t index) { _words[index / word_size] |= top_bit >> (index % word_size); });
+}
+
+std::size_t atomic_bitset::size() const {
+  return _size;
+}
+
+bool atomic_bitset::empty() const {
+  return _size == 0;
+}
+
+bool atomic_bitset::test(std::size_t index, std::memory_order order) const {
+  return (load_word(index / word_size, order) & (top_bit >> (index % word_size))) != 0;
+}
+
+bool atomic_bitset::test_and_set(std::size_t index, std::memory_order order) {
+  word_type mask = top_bit >> (index % word_size);
+  return (word(index / word_size).fetch_or(mask, order) & mask) != 0;
+}
+
+bool atomic_bitset::test_and_reset(std::size_t index, std::memory_order order) {
+  word_type mask = top_bit >> (index % word_size);
+  return (word(index / word_size).fetch_and(~mask, order) & mask) != 0;
+}
+
+bool atomic_bitset::test_and_flip(std::size_t index, std::memory_order order) {
+  word_type mask = top_bit >> (index % word_size);
+  return (word(index / word_size).fetch_xor(mask, order) & mask) != 0;
+}
+
+void atomic_bitset::set(std::size_t index, std::memory_order order) {
+  test_and_set(index, order);
+}
+
+void atomic_bitset::reset(std::size_t index, std::memory_order order) {
+  test_and_reset(index, order);
+}
+
+std::size_t atomic_bitset::fetch_or_range(std::size_t offset, std::size_t count, std::memory_order order) {
+  std::size_t ans = 0;
+  std::size_t end = offset + count;
+  for (std::size_t num = offset / word_size; num * word_size < end; ++num) {
+    word_type mask = ~word_type(0);
+    if (num == offset / word_size) {
+      mask &= ~word_type(0) >> (offset % word_size);
+    }
+    if (end - num * word_size < word_size) {
+      mask &= ~(~word_type(0) >> (end - num * word_size));
+    }
+    ans += std::popcount(word(num).fetch_or(mask, order) & mask);
+  }
+  return ans;
+}
+
+std::size_t atomic_bitset::count(std::memory_order order) const {
+  std::size_t ans = 0;
+  for (std::size_t num = 0; num < _words.size(); ++num) {
+    word_type bits = load_word(num, order);
+    if (num + 1 == _words.size() && _size % word_size != 0) {
+      bits &= ~word_type(0) << (word_size - _size % word_size);
+    }
+    ans += std::popcount(bits);
+  }
+  return ans;
+}
+
+bitset atomic_bitset::to_bitset(std::memory_order order) const {
+  bitset result;
+  result.reserve(_size);
+  for (std::size_t num = 0; num < _words.size(); ++num) {
+    std::size_t bits = std::min(word_size, _size - num * word_size);
+    result.append_word(load_word(num, order) >> (word_size - bits), bits);
+  }
+  return result;
+}
+
+std::atomic_ref<atomic_bitset::word_type> atomic_bitset::word(std::size_t num) {
+  return std::atomic_ref<word_type>(_words[num]);
+}
+
+atomic_bitset::word_type atomic_bitset::load_word(std::size_t num, std::memory_order order) const {
+  // `std::atomic_ref` needs a non-const object even to load, and nothing is stored through this one.
+  return std::atomic_ref<word_type>(const_cast<word_type&>(_words[num])).load(order);
+}
+
+std::size_t atomic_bitset::word_count() const {
+  return _words.size();
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "bitset.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Bitset whose bits can be read and modified concurrently. Words have the layout of `bitset` and are only
+// accessed through `std::atomic_ref`, so single-bit operations are lock-free read-modify-writes with the
+// requested memory order. Whole-range reads such as `count()` load every word atomically but are not a
+// snapshot: bits changed during the call may or may not be seen.
+class atomic_bitset {
+public:
+  using word_type = uint64_t;
+
+  static constexpr std::size_t word_size = 64;
+
+  atomic_bitset() = default;
+  explicit atomic_bitset(std::size_t size, bool value = false);
+  explicit atomic_bitset(const bitset::const_view& view);
+
+  std::size_t size() const;
+  bool empty() const;
+
+  bool test(std::size_t index, std::memory_order order = std::memory_order_seq_cst) const;
+
+  // Return the previous value of the bit.
+  bool test_and_set(std::size_t index, std::memory_order order = std::memory_order_seq_cst);
+  bool test_and_reset(std::size_t index, std::memory_order order = std::memory_order_seq_cst);
+  bool test_and_flip(std::size_t index, std::memory_order order = std::memory_order_seq_cst);
+
+  void set(std::size_t index, std::memory_order order = std::memory_order_seq_cst);
+  void reset(std::size_t index, std::memory_order order = std::memory_order_seq_cst);
+
+  // Sets the bits in [offset, offset + count) with one `fetch_or` per word and returns how many of them were
+  // already set.
+  std::size_t fetch_or_range(
+      std::size_t offset,
+      std::size_t count,
+      std::memory_order order = std::memory_order_seq_cst
+  );
+
+  std::size_t count(std::memory_order order = std::memory_order_relaxed) const;
+
+  bitset to_bitset(std::memory_order order = std::memory_order_seq_cst) const;
+
+  // Word `num`, laid out as in `bitset`, for updates that need a whole word at once, such as claiming any zero
+  // bit with a CAS. Bits of the last word past `size()` are ignored by `count()` and `to_bitset()`.
+  std::atomic_ref<word_type> word(std::size_t num);
+  word_type load_word(std::size_t num, std::memory_order order = std::memory_order_seq_cst) const;
+  std::size_t word_count() const;
+
+private:
+  static_assert(std::atomic_ref<word_type>::is_always_lock_free);
+  static_assert(alignof(word_type) >= std::atomic_ref<word_type>::required_alignment);
+
+  static constexpr word_type top_bit = word_type(1) << (word_size - 1);
+
+  std::vector<word_type> _words;
+  std::size_t _size = 0;
+};
@@ -0,0 +1,350 @@
+#include "bitset-compressed.h"
+
+#include <algorithm>
+#include <array>
+#include <functional>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+namespace {
+
+using word_type = compressed_bitset::word_type;
+
+constexpr std::size_t word_size = compressed_bitset::word_size;
+constexpr std::size_t chunk_bits = compressed_bitset::chunk_bits;
+constexpr std::size_t chunk_words = chunk_bits / word_size;
+constexpr std::size_t array_limit = 4096;
+constexpr word_type top_bit = word_type(1) << (word_size - 1);
+
+// Smallest position at or after `from` whose bit equals `value`, or `chunk_bits`.
+std::size_t next_bit(const word_type* words, std::size_t from, bool value) {
+  if (from >= chunk_bits) {
+    return chunk_bits;
+  }
+  std::size_t num = from / word_size;
+  word_type bits = (value ? words[num] : ~words[num]) & (~word_type(0) >> (from % word_size));
+  while (bits == 0) {
+    if (++num == chunk_words) {
+      return chunk_bits;
+    }
+    bits = value ? words[num] : ~words[num];
+  }
+  return num * word_size + std::countl_zero(bits);
+}
+
+void set_range(word_type* words, std::size_t begin, std::size_t end) {
+  std::size_t first = begin / word_size;
+  std::size_t last = (end - 1) / word_size;
+  word_type head = ~word_type(0) >> (begin % word_size);
+  word_type tail = ~word_type(0) << (word_size - 1 - (end - 1) % word_size);
+  if (first == last) {
+    words[first] |= head & tail;
+    return;
+  }
+  words[first] |= head;
+  std::fill(words + first + 1, words + last, ~word_type(0));
+  words[last] |= tail;
+}
+
+// A chunk takes a run container only when it is strictly smaller than both alternatives, so every set of bits has
+// exactly one representation and containers can be compared directly.
+bool prefer_runs(std::size_t ones, std::size_t runs) {
+  std::size_t array_bytes = (ones <= array_limit) ? ones * sizeof(uint16_t) : chunk_bits;
+  std::size_t bitmap_bytes = chunk_words * sizeof(word_type);
+  return runs * 2 * sizeof(uint16_t) < std::min(array_bytes, bitmap_bytes);
+}
+
+} // namespace
+
+compressed_bitset::compressed_bitset(std::size_t size)
+    : _size(size) {}
+
+compressed_bitset::compressed_bitset(const bitset::const_view& view)
+    : _size(view.size()) {
+  std::array<word_type, chunk_words> words;
+  for (std::size_t first = 0; first < _size; first += chunk_bits) {
+    std::size_t bits = std::min(chunk_bits, _size - first);
+    words.fill(0);
+    auto chunk = bitset_detail::as_expression(view.subview(first, bits));
+    chunk.for_each_word([&words, num = std::size_t(0)](word_type word, std::size_t /*count*/) mutable {
+      words[num++] = word;
+      return true;
+    });
+
+    container data = make_container(words.data());
+    if (cardinality(data) != 0) {
+      _chunks.push_back({uint32_t(first / chunk_bits), std::move(data)});
+    }
+  }
+}
+
+std::size_t compressed_bitset::size() const {
+  return _size;
+}
+
+bool compressed_bitset::empty() const {
+  return _size == 0;
+}
+
+std::size_t compressed_bitset::count() const {
+  std::size_t ans = 0;
+  for (const chunk& current : _chunks) {
+    ans += cardinality(current.data);
+  }
+  return ans;
+}
+
+bool compressed_bitset::any() const {
+  return !_chunks.empty();
+}
+
+bool compressed_bitset::contains(std::size_t index) const {
+  if (index >= _size) {
+    return false;
+  }
+  uint32_t key = uint32_t(index / chunk_bits);
+  auto it = std::lower_bound(_chunks.begin(), _chunks.end(), key, [](const chunk& current, uint32_t value) {
+    return current.key < value;
+  });
+  return it != _chunks.end() && it->key == key && contains(it->data, uint16_t(index % chunk_bits));
+}
+
+bitset compressed_bitset::to_bitset() const {
+  bitset result(_size, false);
+  word_type* words = result.begin().word_pointer();
+  std::size_t word_count = (_size + word_size - 1) / word_size;
+  for (const chunk& current : _chunks) {
+    std::size_t first = std::size_t(current.key) * chunk_words;
+    write_words(current.data, words + first, std::min(chunk_words, word_count - first));
+  }
+  return result;
+}
+
+compressed_bitset& compressed_bitset::operator&=(const compressed_bitset& other) & {
+  combine(other, std::bit_and<>());
+  return *this;
+}
+
+compressed_bitset& compressed_bitset::operator|=(const compressed_bitset& other) & {
+  combine(other, std::bit_or<>());
+  return *this;
+}
+
+compressed_bitset& compressed_bitset::operator^=(const compressed_bitset& other) & {
+  combine(other, std::bit_xor<>());
+  return *this;
+}
+
+std::size_t compressed_bitset::memory_usage() const {
+  std::size_t ans = _chunks.capacity() * sizeof(chunk);
+  for (const chunk& current : _chunks) {
+    if (auto* array = std::get_if<array_container>(&current.data)) {
+      ans += array->values.capacity() * sizeof(uint16_t);
+    } else if (auto* bitmap = std::get_if<bitmap_container>(&current.data)) {
+      ans += bitmap->words.capacity() * sizeof(word_type);
+    } else {
+      ans += std::get<run_container>(current.data).runs.capacity() * sizeof(run);
+    }
+  }
+  return ans;
+}
+
+compressed_bitset::container compressed_bitset::make_container(const word_type* words) {
+  std::size_t ones = 0;
+  std::size_t runs = 0;
+  word_type previous = 0;
+  for (std::size_t num = 0; num < chunk_words; ++num) {
+    word_type bits = words[num];
+    ones += std::popcount(bits);
+    runs += std::popcount(bits & ~((bits >> 1) | (previous << (word_size - 1))));
+    previous = bits;
+  }
+
+  if (prefer_runs(ones, runs)) {
+    run_container result;
+    result.runs.reserve(runs);
+    for (std::size_t start = next_bit(words, 0, true); start != chunk_bits;) {
+      std::size_t end = next_bit(words, start, false);
+      result.runs.push_back({uint16_t(start), uint16_t(end - start - 1)});
+      start = next_bit(words, end, true);
+    }
+    return result;
+  }
+  if (ones <= array_limit) {
+    array_container result;
+    result.values.reserve(ones);
+    for (std::size_t num = 0; num < chunk_words; ++num) {
+      for (word_type bits = words[num]; bits != 0;) {
+        int zeros = std::countl_zero(bits);
+        result.values.push_back(uint16_t(num * word_size + zeros));
+        bits ^= top_bit >> zeros;
+      }
+    }
+    return result;
+  }
+  return bitmap_container{std::vector<word_type>(words, words + chunk_words), ones};
+}
+
+compressed_bitset::container compressed_bitset::make_container(std::vector<uint16_t> values) {
+  std::size_t runs = 0;
+  for (std::size_t i = 0; i < values.size(); ++i) {
+    runs += (i == 0 || values[i] != values[i - 1] + 1);
+  }
+
+  if (prefer_runs(values.size(), runs)) {
+    run_container result;
+    result.runs.reserve(runs);
+    for (uint16_t value : values) {
+      if (!result.runs.empty() && result.runs.back().start + result.runs.back().length + 1 == value) {
+        ++result.runs.back().length;
+      } else {
+        result.runs.push_back({value, 0});
+      }
+    }
+    return result;
+  }
+  if (values.size() <= array_limit) {
+    return array_container{std::move(values)};
+  }
+  std::vector<word_type> words(chunk_words);
+  for (uint16_t value : values) {
+    words[value / word_size] |= top_bit >> (value % word_size);
+  }
+  return bitmap_container{std::move(words), values.size()};
+}
+
+std::size_t compressed_bitset::cardinality(const container& data) {
+  if (auto* array = std::get_if<array_container>(&data)) {
+    return array->values.size();
+  }
+  if (auto* bitmap = std::get_if<bitmap_container>(&data)) {
+    return bitmap->cardinality;
+  }
+  std::size_t ans = 0;
+  for (run r : std::get<run_container>(data).runs) {
+    ans += std::size_t(r.length) + 1;
+  }
+  return ans;
+}
+
+bool compressed_bitset::contains(const container& data, uint16_t value) {
+  if (auto* array = std::get_if<array_container>(&data)) {
+    return std::binary_search(array->values.begin(), array->values.end(), value);
+  }
+  if (auto* bitmap = std::get_if<bitmap_container>(&data)) {
+    return (bitmap->words[value / word_size] & (top_bit >> (value % word_size))) != 0;
+  }
+  const std::vector<run>& runs = std::get<run_container>(data).runs;
+  auto it = std::upper_bound(runs.begin(), runs.end(), value, [](uint16_t position, const run& r) {
+    return position < r.start;
+  });
+  return it != runs.begin() && value - std::prev(it)->start <= std::prev(it)->length;
+}
+
+void compressed_bitset::write_words(const container& data, word_type* words, std::size_t word_count) {
+  if (auto* array = std::get_if<array_container>(&data)) {
+    for (uint16_t value : array->values) {
+      words[value / word_size] |= top_bit >> (value % word_size);
+    }
+  } else if (auto* bitmap = std::get_if<bitmap_container>(&data)) {
+    for (std::size_t num = 0; num < word_count; ++num) {
+      words[num] |= bitmap->words[num];
+    }
+  } else {
+    for (run r : std::get<run_container>(data).runs) {
+      set_range(words, r.start, std::size_t(r.start) + r.length + 1);
+    }
+  }
+}
+
+template <typename Operation>
+compressed_bitset::container
+compressed_bitset::combine(const container& lhs, const container& rhs, Operation operation) {
+  constexpr bool intersection = std::is_same_v<Operation, std::bit_and<>>;
+  auto* left = std::get_if<array_container>(&lhs);
+  auto* right = std::get_if<array_container>(&rhs);
+
+  if (left != nullptr && right != nullptr) {
+    const std::vector<uint16_t>& a = left->values;
+    const std::vector<uint16_t>& b = right->values;
+    std::vector<uint16_t> values;
+    if constexpr (intersection) {
+      std::set_intersection(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(values));
+    } else if constexpr (std::is_same_v<Operation, std::bit_or<>>) {
+      std::set_union(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(values));
+    } else {
+      std::set_symmetric_difference(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(values));
+    }
+    return make_container(std::move(values));
+  }
+
+  if constexpr (intersection) {
+    if (left != nullptr || right != nullptr) {
+      const std::vector<uint16_t>& values = (left != nullptr) ? left->values : right->values;
+      const container& other = (left != nullptr) ? rhs : lhs;
+      std::vector<uint16_t> result;
+      std::copy_if(values.begin(), values.end(), std::back_inserter(result), [&other](uint16_t value) {
+        return contains(other, value);
+      });
+      return make_container(std::move(result));
+    }
+  }
+
+  std::array<word_type, chunk_words> words{};
+  std::array<word_type, chunk_words> other{};
+  write_words(lhs, words.data(), chunk_words);
+  write_words(rhs, other.data(), chunk_words);
+  for (std::size_t num = 0; num < chunk_words; ++num) {
+    words[num] = operation(words[num], other[num]);
+  }
+  return make_container(words.data());
+}
+
+template <typename Operation>
+void compressed_bitset::combine(const compressed_bitset& other, Operation operation) {
+  constexpr bool intersection = std::is_same_v<Operation, std::bit_and<>>;
+  std::vector<chunk> result;
+  auto left = _chunks.begin();
+  auto right = other._chunks.begin();
+  while (left != _chunks.end() || right != other._chunks.end()) {
+    if (right == other._chunks.end() || (left != _chunks.end() && left->key < right->key)) {
+      if (!intersection) {
+        result.push_back(std::move(*left));
+      }
+      ++left;
+    } else if (left == _chunks.end() || right->key < left->key) {
+      if (!intersection) {
+        result.push_back(*right);
+      }
+      ++right;
+    } else {
+      container data = combine(left->data, right->data, operation);
+      if (cardinality(data) != 0) {
+        result.push_back({left->key, std::move(data)});
+      }
+      ++left;
+      ++right;
+    }
+  }
+  _chunks = std::move(result);
+  _size = std::max(_size, other._size);
+}
+
+compressed_bitset operator&(const compressed_bitset& lhs, const compressed_bitset& rhs) {
+  compressed_bitset result(lhs);
+  result &= rhs;
+  return result;
+}
+
+compressed_bitset operator|(const compressed_bitset& lhs, const compressed_bitset& rhs) {
+  compressed_bitset result(lhs);
+  result |= rhs;
+  return result;
+}
+
+compressed_bitset operator^(const compressed_bitset& lhs, const compressed_bitset& rhs) {
+  compressed_bitset result(lhs);
+  result ^= rhs;
+  return result;
+}
@@ -0,0 +1,138 @@
+#pragma once
+
+#include "bitset.h"
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <variant>
+#include <vector>
+
+// Roaring-style compressed bitmap. Bits are split into chunks of 2^16; empty chunks are not stored, and each
+// other chunk keeps whichever container is smallest for its contents: a sorted array of up to 4096 positions,
+// a 1024-word bitmap in the same layout as `bitset`, or a list of runs. Operations work chunk by chunk and
+// never expand the whole bitmap.
+class compressed_bitset {
+public:
+  using word_type = uint64_t;
+
+  static constexpr std::size_t chunk_bits = std::size_t(1) << 16;
+  static constexpr std::size_t word_size = 64;
+
+  compressed_bitset() = default;
+  explicit compressed_bitset(std::size_t size);
+  explicit compressed_bitset(const bitset::const_view& view);
+
+  std::size_t size() const;
+  bool empty() const;
+
+  std::size_t count() const;
+  bool any() const;
+  bool contains(std::size_t index) const;
+
+  bitset to_bitset() const;
+
+  // Calls `function(index)` for every set bit in increasing order.
+  template <typename Function>
+  void for_each(Function function) const;
+
+  // The result has the size of the longer operand.
+  compressed_bitset& operator&=(const compressed_bitset& other) &;
+  compressed_bitset& operator|=(const compressed_bitset& other) &;
+  compressed_bitset& operator^=(const compressed_bitset& other) &;
+
+  // Bytes owned by the bitmap, including its containers.
+  std::size_t memory_usage() const;
+
+  friend bool operator==(const compressed_bitset& lhs, const compressed_bitset& rhs) = default;
+
+private:
+  static constexpr std::size_t chunk_words = chunk_bits / word_size;
+
+  struct array_container {
+    std::vector<uint16_t> values;
+
+    friend bool operator==(const array_container&, const array_container&) = default;
+  };
+
+  struct bitmap_container {
+    std::vector<word_type> words;
+    std::size_t cardinality;
+
+    friend bool operator==(const bitmap_container&, const bitmap_container&) = default;
+  };
+
+  // Runs of set bits `[start, start + length]`.
+  struct run {
+    uint16_t start;
+    uint16_t length;
+
+    friend bool operator==(const run&, const run&) = default;
+  };
+
+  struct run_container {
+    std::vector<run> runs;
+
+    friend bool operator==(const run_container&, const run_container&) = default;
+  };
+
+  using container = std::variant<array_container, bitmap_container, run_container>;
+
+  struct chunk {
+    uint32_t key;
+    container data;
+
+    friend bool operator==(const chunk&, const chunk&) = default;
+  };
+
+  static container make_container(const word_type* words);
+  static container make_container(std::vector<uint16_t> values);
+  static std::size_t cardinality(const container& data);
+  static bool contains(const container& data, uint16_t value);
+  static void write_words(const container& data, word_type* words, std::size_t word_count);
+
+  template <typename Operation>
+  static container combine(const container& lhs, const container& rhs, Operation operation);
+
+  template <typename Operation>
+  void combine(const compressed_bitset& other, Operation operation);
+
+  std::vector<chunk> _chunks;
+  std::size_t _size = 0;
+};
+
+compressed_bitset operator&(const compressed_bitset& lhs, const compressed_bitset& rhs);
+compressed_bitset operator|(const compressed_bitset& lhs, const compressed_bitset& rhs);
+compressed_bitset operator^(const compressed_bitset& lhs, const compressed_bitset& rhs);
+
+template <typename Function>
+void for_each_set_bit(const compressed_bitset& bs, Function function) {
+  bs.for_each(function);
+}
+
+template <typename Function>
+void compressed_bitset::for_each(Function function) const {
+  for (const chunk& current : _chunks) {
+    std::size_t base = std::size_t(current.key) * chunk_bits;
+    if (auto* array = std::get_if<array_container>(&current.data)) {
+      for (uint16_t value : array->values) {
+        function(base + value);
+      }
+    } else if (auto* bitmap = std::get_if<bitmap_container>(&current.data)) {
+      for (std::size_t num = 0; num < chunk_words; ++num) {
+        word_type bits = bitmap->words[num];
+        while (bits != 0) {
+          int zeros = std::countl_zero(bits);
+          function(base + num * word_size + zeros);
+          bits ^= (word_type(1) << (word_size - 1)) >> zeros;
+        }
+      }
+    } else {
+      for (run r : std::get<run_container>(current.data).runs) {
+        for (std::size_t i = r.start; i <= std::size_t(r.start) + r.length; ++i) {
+          function(base + i);
+        }
+      }
+    }
+  }
+}
@@ -0,0 +1,310 @@
+#include "bitset-dispatch.h"
+
+// The helpers from bitset-simd.h are always inlined into kernels compiled for a matching target, so the ABI
+// of passing wide vectors to non-inlined functions never comes into play.
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic ignored "-Wpsabi"
+#endif
+
+#include "bitset-simd.h"
+
+#include <atomic>
+#include <cstdlib>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define BITSET_X86 1
+#include <immintrin.h>
+#endif
+
+namespace bitset_simd {
+
+namespace {
+
+// Every kernel set is the same generic code instantiated for a block width and compiled for a target, so that
+// a single binary carries all of them and picks one at runtime.
+#define BITSET_DEFINE_KERNELS(NAME, WIDTH, TARGET)                                                               \
+  namespace NAME {                                                                                               \
+  TARGET void and_words(word_type* dst, const word_type* src, std::size_t count, std::size_t shift) {            \
+    binary<WIDTH>(dst, src, count, shift, and_operation{});                                                      \
+  }                                                                                                              \
+  TARGET void or_words(word_type* dst, const word_type* src, std::size_t count, std::size_t shift) {             \
+    binary<WIDTH>(dst, src, count, shift, or_operation{});                                                       \
+  }                                                                                                              \
+  TARGET void xor_words(word_type* dst, const word_type* src, std::size_t count, std::size_t shift) {            \
+    binary<WIDTH>(dst, src, count, shift, xor_operation{});                                                      \
+  }                                                                                                              \
+  TARGET void flip_words(word_type* dst, std::size_t count) {                                                    \
+    unary<WIDTH>(dst, count, flip_operation{});                                                                  \
+  }                                                                                                              \
+  TARGET void set_words(word_type* dst, std::size_t count) {                                                     \
+    unary<WIDTH>(dst, count, set_operation{});                                                                   \
+  }                                                                                                              \
+  TARGET void reset_words(word_type* dst, std::size_t count) {                                                   \
+    unary<WIDTH>(dst, count, reset_operation{});                                                                 \
+  }                                                                                                              \
+  TARGET std::size_t count_words(const word_type* src, std::size_t count) {                                      \
+    return bitset_simd::count<WIDTH>(src, count);                                                                \
+  }                                                                                                              \
+  TARGET bool match_words(const word_type* src, std::size_t count, word_type pattern) {                          \
+    return match<WIDTH>(src, count, pattern);                                                                    \
+  }                                                                                                              \
+  TARGET bool equal_words(const word_type* lhs, const word_type* rhs, std::size_t count, std::size_t shift) {    \
+    return equal<WIDTH>(lhs, rhs, count, shift);                                                                 \
+  }                                                                                                              \
+  TARGET std::size_t find_words(const word_type* src, std::size_t count, word_type pattern) {                    \
+    return find<WIDTH>(src, count, pattern);                                                                     \
+  }                                                                                                              \
+  TARGET std::size_t find_last_words(const word_type* src, std::size_t count, word_type pattern) {               \
+    return find_last<WIDTH>(src, count, pattern);                                                                \
+  }                                                                                                              \
+  TARGET std::size_t and_count_words(                                                                            \
+      const word_type* lhs, const word_type* rhs, std::size_t count, std::size_t shift                           \
+  ) {                                                                                                            \
+    return count_binary<WIDTH>(lhs, rhs, count, shift, and_operation{});                                         \
+  }                                                                                                              \
+  TARGET std::size_t or_count_words(                                                                             \
+      const word_type* lhs, const word_type* rhs, std::size_t count, std::size_t shift                           \
+  ) {                                                                                                            \
+    return count_binary<WIDTH>(lhs, rhs, count, shift, or_operation{});                                          \
+  }                                                                                                              \
+  TARGET std::size_t xor_count_words(                                                                            \
+      const word_type* lhs, const word_type* rhs, std::size_t count, std::size_t shift                           \
+  ) {                                                                                                            \
+    return count_binary<WIDTH>(lhs, rhs, count, shift, xor_operation{});                                         \
+  }                                                                                                              \
+  TARGET std::size_t andnot_count_words(                                                                         \
+      const word_type* lhs, const word_type* rhs, std::size_t count, std::size_t shift                           \
+  ) {                                                                                                            \
+    return count_binary<WIDTH>(lhs, rhs, count, shift, andnot_operation{});                                      \
+  }                                                                                                              \
+  TARGET bool and_any_words(const word_type* lhs, const word_type* rhs, std::size_t count, std::size_t shift) {  \
+    return any_binary<WIDTH>(lhs, rhs, count, shift, and_operation{});                                           \
+  }                                                                                                              \
+  TARGET bool andnot_any_words(                                                                                  \
+      const word_type* lhs, const word_type* rhs, std::size_t count, std::size_t shift                           \
+  ) {                                                                                                            \
+    return any_binary<WIDTH>(lhs, rhs, count, shift, andnot_operation{});                                        \
+  }                                                                                                              \
+  constexpr kernels table = {                                                                                    \
+      and_words,                                                                                                 \
+      or_words,                                                                                                  \
+      xor_words,                                                                                                 \
+      flip_words,                                                                                                \
+      set_words,                                                                                                 \
+      reset_words,                                                                                               \
+      count_words,                                                                                               \
+      match_words,                                                                                               \
+      equal_words,                                                                                               \
+      find_words,                                                                                                \
+      find_last_words,                                                                                           \
+      and_count_words,                                                                                           \
+      or_count_words,                                                                                            \
+      xor_count_words,                                                                                           \
+      andnot_count_words,                                                                                        \
+      and_any_words,                                                                                             \
+      andnot_any_words,                                                                                          \
+  };                                                                                                             \
+  }
+
+BITSET_DEFINE_KERNELS(scalar_kernels, 1, )
+
+#if defined(BITSET_X86)
+BITSET_DEFINE_KERNELS(simd128_kernels, 2, [[gnu::target("sse2")]])
+BITSET_DEFINE_KERNELS(avx2_kernels, 4, [[gnu::target("avx2,popcnt")]])
+BITSET_DEFINE_KERNELS(avx512_kernels, 8, [[gnu::target("avx512f,popcnt")]])
+
+[[gnu::target("avx512f,avx512vpopcntdq")]] std::size_t count_words_vpopcnt(const word_type* src, std::size_t count) {
+  __m512i sum = _mm512_setzero_si512();
+  std::size_t i = 0;
+  for (; i + 8 <= count; i += 8) {
+    sum = _mm512_add_epi64(sum, _mm512_popcnt_epi64(_mm512_loadu_si512(src + i)));
+  }
+  alignas(64) uint64_t lanes[8];
+  _mm512_store_si512(lanes, sum);
+  std::size_t result = 0;
+  for (uint64_t lane : lanes) {
+    result += lane;
+  }
+  for (; i < count; ++i) {
+    result += std::popcount(src[i]);
+  }
+  return result;
+}
+
+template <typename Function>
+[[gnu::target("avx512f,avx512vpopcntdq")]] std::size_t count_binary_vpopcnt(
+    const word_type* lhs,
+    const word_type* rhs,
+    std::size_t count,
+    std::size_t shift,
+    Function operation
+) {
+  __m512i sum = _mm512_setzero_si512();
+  std::size_t i = 0;
+  for (; i + 8 <= count; i += 8) {
+    block<8> value = operation(load<8>(lhs + i), (shift == 0) ? load<8>(rhs + i) : load_shifted<8>(rhs + i, shift));
+    sum = _mm512_add_epi64(sum, _mm512_popcnt_epi64(__m512i(value)));
+  }
+  alignas(64) uint64_t lanes[8];
+  _mm512_store_si512(lanes, sum);
+  std::size_t result = 0;
+  for (uint64_t lane : lanes) {
+    result += lane;
+  }
+  return result + count_binary<1>(lhs + i, rhs + i, count - i, shift, operation);
+}
+
+[[gnu::target("avx512f,avx512vpopcntdq")]] std::size_t
+and_count_words_vpopcnt(const word_type* lhs, const word_type* rhs, std::size_t count, std::size_t shift) {
+  return count_binary_vpopcnt(lhs, rhs, count, shift, and_operation{});
+}
+
+[[gnu::target("avx512f,avx512vpopcntdq")]] std::size_t
+or_count_words_vpopcnt(const word_type* lhs, const word_type* rhs, std::size_t count, std::size_t shift) {
+  return count_binary_vpopcnt(lhs, rhs, count, shift, or_operation{});
+}
+
+[[gnu::target("avx512f,avx512vpopcntdq")]] std::size_t
+xor_count_words_vpopcnt(const word_type* lhs, const word_type* rhs, std::size_t count, std::size_t shift) {
+  return count_binary_vpopcnt(lhs, rhs, count, shift, xor_operation{});
+}
+
+[[gnu::target("avx512f,avx512vpopcntdq")]] std::size_t
+andnot_count_words_vpopcnt(const word_type* lhs, const word_type* rhs, std::size_t count, std::size_t shift) {
+  return count_binary_vpopcnt(lhs, rhs, count, shift, andnot_operation{});
+}
+#elif defined(__ARM_NEON)
+BITSET_DEFINE_KERNELS(simd128_kernels, 2, )
+#endif
+
+#undef BITSET_DEFINE_KERNELS
+
+bool cpu_supports(backend value) noexcept {
+#if defined(BITSET_X86)
+  __builtin_cpu_init();
+  switch (value) {
+  case backend::scalar:
+    return true;
+  case backend::simd128:
+    return __builtin_cpu_supports("sse2");
+  case backend::avx2:
+    return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt");
+  case backend::avx512:
+    return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("popcnt");
+  }
+  return false;
+#elif defined(__ARM_NEON)
+  return value == backend::scalar || value == backend::simd128;
+#else
+  return value == backend::scalar;
+#endif
+}
+
+const kernels& kernels_for(backend value) noexcept {
+  switch (value) {
+  case backend::scalar:
+    return scalar_kernels::table;
+#if defined(BITSET_X86)
+  case backend::simd128:
+    return simd128_kernels::table;
+  case backend::avx2:
+    return avx2_kernels::table;
+  case backend::avx512: {
+    static const kernels table = [] {
+      kernels result = avx512_kernels::table;
+      if (__builtin_cpu_supports("avx512vpopcntdq")) {
+        result.count_words = count_words_vpopcnt;
+        result.and_count_words = and_count_words_vpopcnt;
+        result.or_count_words = or_count_words_vpopcnt;
+        result.xor_count_words = xor_count_words_vpopcnt;
+        result.andnot_count_words = andnot_count_words_vpopcnt;
+      }
+      return result;
+    }();
+    return table;
+  }
+#elif defined(__ARM_NEON)
+  case backend::simd128:
+    return simd128_kernels::table;
+#endif
+  default:
+    return scalar_kernels::table;
+  }
+}
+
+backend initial_backend() noexcept {
+  if (const char* name = std::getenv("BITSET_BACKEND")) {
+    std::optional<backend> requested = backend_from_string(name);
+    if (requested && cpu_supports(*requested)) {
+      return *requested;
+    }
+  }
+  return best_backend();
+}
+
+std::atomic<backend>& current() noexcept {
+  static std::atomic<backend> value{initial_backend()};
+  return value;
+}
+
+std::atomic<const kernels*>& current_kernels() noexcept {
+  static std::atomic<const kernels*> value{&kernels_for(current().load(std::memory_order_relaxed))};
+  return value;
+}
+
+} // namespace
+
+const kernels& active_kernels() noexcept {
+  return *current_kernels().load(std::memory_order_acquire);
+}
+
+backend active_backend() noexcept {
+  return current().load(std::memory_order_relaxed);
+}
+
+backend best_backend() noexcept {
+  for (backend value : {backend::avx512, backend::avx2, backend::simd128}) {
+    if (cpu_supports(value)) {
+      return value;
+    }
+  }
+  return backend::scalar;
+}
+
+bool is_supported(backend value) noexcept {
+  return cpu_supports(value);
+}
+
+bool select_backend(backend value) noexcept {
+  if (!cpu_supports(value)) {
+    return false;
+  }
+  current().store(value, std::memory_order_relaxed);
+  current_kernels().store(&kernels_for(value), std::memory_order_release);
+  return true;
+}
+
+std::string_view to_string(backend value) noexcept {
+  switch (value) {
+  case backend::scalar:
+    return "scalar";
+  case backend::simd128:
+    return "simd128";
+  case backend::avx2:
+    return "avx2";
+  case backend::avx512:
+    return "avx512";
+  }
+  return "unknown";
+}
+
+std::optional<backend> backend_from_string(std::string_view name) noexcept {
+  for (backend value : {backend::scalar, backend::simd128, backend::avx2, backend::avx512}) {
+    if (to_string(value) == name) {
+      return value;
+    }
+  }
+  return std::nullopt;
+}
+
+} // namespace bitset_simd
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+namespace bitset_simd {
+
+enum class backend {
+  scalar,
+  simd128,
+  avx2,
+  avx512,
+};
+
+// Word-level loops behind `bitset_view`. All of them work on whole words only; views handle their partial
+// head and tail words themselves.
+template <typename W>
+struct basic_kernels {
+  using word_type = W;
+
+  void (*and_words)(word_type* dst, const word_type* src, std::size_t count, std::size_t shift);
+  void (*or_words)(word_type* dst, const word_type* src, std::size_t count, std::size_t shift);
+  void (*xor_words)(word_type* dst, const word_type* src, std::size_t count, std::size_t shift);
+  void (*flip_words)(word_type* dst, std::size_t count);
+  void (*set_words)(word_type* dst, std::size_t count);
+  void (*reset_words)(word_type* dst, std::size_t count);
+  std::size_t (*count_words)(const word_type* src, std::size_t count);
+  bool (*match_words)(const word_type* src, std::size_t count, word_type pattern);
+  bool (*equal_words)(const word_type* lhs, const word_type* rhs, std::size_t count, std::size_t shift);
+  // Index of the first (last) word that differs from `pattern`, or `count` if all of them match.
+  std::size_t (*find_words)(const word_type* src, std::size_t count, word_type pattern);
+  std::size_t (*find_last_words)(const word_type* src, std::size_t count, word_type pattern);
+  // Ones in `lhs op rhs'` for whole words, where `rhs'` starts `shift` bits into `rhs` as in `and_words`; the
+  // `any` variants only check that there is one.
+  std::size_t (*and_count_words)(const word_type* lhs, const word_type* rhs, std::size_t count, std::size_t shift);
+  std::size_t (*or_count_words)(const word_type* lhs, const word_type* rhs, std::size_t count, std::size_t shift);
+  std::size_t (*xor_count_words)(const word_type* lhs, const word_type* rhs, std::size_t count, std::size_t shift);
+  std::size_t (*andnot_count_words)(const word_type* lhs, const word_type* rhs, std::size_t count, std::size_t shift);
+  bool (*and_any_words)(const word_type* lhs, const word_type* rhs, std::size_t count, std::size_t shift);
+  bool (*andnot_any_words)(const word_type* lhs, const word_type* rhs, std::size_t count, std::size_t shift);
+};
+
+using kernels = basic_kernels<uint64_t>;
+
+const kernels& active_kernels() noexcept;
+
+backend active_backend() noexcept;
+backend best_backend() noexcept;
+bool is_supported(backend value) noexcept;
+
+// Returns `false` and keeps the current backend if `value` is not supported by this CPU.
+bool select_backend(backend value) noexcept;
+
+std::string_view to_string(backend value) noexcept;
+std::optional<backend> backend_from_string(std::string_view name) noexcept;
+
+} // namespace bitset_simd
@@ -0,0 +1,237 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <type_traits>
+#include <utility>
+
+template <typename W>
+class basic_bitset;
+
+template <typename U>
+class bitset_view;
+
+// Base of lazily evaluated bitwise expressions over views. `Derived` provides `size()` and
+// `get_word(num, count)`, which returns the `num`-th word of the result with only its `count` high bits used
+// and the rest cleared.
+template <typename Derived>
+class bitset_expression {
+public:
+  using word_type = uint64_t;
+  static constexpr std::size_t word_size = 64;
+
+  bool empty() const {
+    return self().size() == 0;
+  }
+
+  std::size_t count() const {
+    std::size_t ans = 0;
+    for_each_word([&ans](word_type word, std::size_t /*count*/) {
+      ans += std::popcount(word);
+      return true;
+    });
+    return ans;
+  }
+
+  bool all() const {
+    return for_each_word([](word_type word, std::size_t count) { return word == high_mask(count); });
+  }
+
+  bool any() const {
+    return !for_each_word([](word_type word, std::size_t /*count*/) { return word == 0; });
+  }
+
+  template <typename Function>
+  bool for_each_word(Function function) const {
+    std::size_t size = self().size();
+    for (std::size_t num = 0; num * word_size < size; ++num) {
+      std::size_t count = std::min(word_size, size - num * word_size);
+      if (!function(self().get_word(num, count), count)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+protected:
+  static word_type high_mask(std::size_t count) {
+    return ~word_type(0) << (word_size - count);
+  }
+
+private:
+  const Derived& self() const {
+    return static_cast<const Derived&>(*this);
+  }
+};
+
+template <typename T>
+concept bitset_expression_type = std::derived_from<T, bitset_expression<T>>;
+
+template <typename View>
+class bitset_view_expression : public bitset_expression<bitset_view_expression<View>> {
+public:
+  using word_type = uint64_t;
+
+  explicit bitset_view_expression(const View& view)
+      : _view(view) {}
+
+  std::size_t size() const {
+    return _view.size();
+  }
+
+  word_type get_word(std::size_t num, std::size_t count) const {
+    return _view.get_word(num, count);
+  }
+
+  // Whether the expression reads any of the words in [first, last).
+  bool overlaps(const word_type* first, const word_type* last) const {
+    return _view.overlaps(first, last);
+  }
+
+private:
+  View _view;
+};
+
+template <typename Operation, typename Left, typename Right>
+class bitset_binary_expression : public bitset_expression<bitset_binary_expression<Operation, Left, Right>> {
+public:
+  using word_type = uint64_t;
+
+  bitset_binary_expression(Left left, Right right)
+      : _left(std::move(left))
+      , _right(std::move(right)) {}
+
+  std::size_t size() const {
+    return _left.size();
+  }
+
+  word_type get_word(std::size_t num, std::size_t count) const {
+    return Operation()(_left.get_word(num, count), _right.get_word(num, count));
+  }
+
+  bool overlaps(const word_type* first, const word_type* last) const {
+    return _left.overlaps(first, last) || _right.overlaps(first, last);
+  }
+
+private:
+  Left _left;
+  Right _right;
+};
+
+template <typename Operand>
+class bitset_not_expression : public bitset_expression<bitset_not_expression<Operand>> {
+public:
+  using word_type = uint64_t;
+
+  explicit bitset_not_expression(Operand operand)
+      : _operand(std::move(operand)) {}
+
+  std::size_t size() const {
+    return _operand.size();
+  }
+
+  word_type get_word(std::size_t num, std::size_t count) const {
+    return ~_operand.get_word(num, count) & this->high_mask(count);
+  }
+
+  bool overlaps(const word_type* first, const word_type* last) const {
+    return _operand.overlaps(first, last);
+  }
+
+private:
+  Operand _operand;
+};
+
+// Anything an expression can be built from: expressions themselves, bitsets and views.
+template <typename T>
+concept bitset_operand = bitset_expression_type<std::remove_cvref_t<T>> ||
+                         std::convertible_to<const std::remove_cvref_t<T>&, bitset_view<const uint64_t>>;
+
+template <std::size_t N>
+class static_bitset;
+
+template <typename T>
+inline constexpr bool is_static_bitset = false;
+
+template <std::size_t N>
+inline constexpr bool is_static_bitset<static_bitset<N>> = true;
+
+// Temporary bitsets and static bitsets are excluded: the eager overloads evaluate them, reusing a bitset's storage,
+// instead of keeping a view of an object that is about to be destroyed.
+template <typename T>
+concept bitset_lazy_operand = bitset_operand<T> && !std::is_same_v<std::remove_const_t<T>, basic_bitset<uint64_t>> &&
+                              !is_static_bitset<std::remove_const_t<T>>;
+
+// Static bitsets combine with each other through their own constexpr operators.
+template <typename L, typename R>
+concept bitset_lazy_operands = bitset_lazy_operand<L> && bitset_lazy_operand<R> &&
+                               !(is_static_bitset<std::remove_cvref_t<L>> && is_static_bitset<std::remove_cvref_t<R>>);
+
+namespace bitset_detail {
+
+template <typename T>
+auto as_expression(const T& value) {
+  if constexpr (bitset_expression_type<T>) {
+    return value;
+  } else {
+    using const_view = bitset_view<const uint64_t>;
+    return bitset_view_expression<const_view>(const_view(value));
+  }
+}
+
+template <typename Operation, typename L, typename R>
+auto make_binary_expression(const L& lhs, const R& rhs) {
+  auto left = as_expression(lhs);
+  auto right = as_expression(rhs);
+  return bitset_binary_expression<Operation, decltype(left), decltype(right)>(std::move(left), std::move(right));
+}
+
+} // namespace bitset_detail
+
+template <typename L, typename R>
+  requires bitset_lazy_operands<L, R>
+auto operator&(L&& lhs, R&& rhs) {
+  return bitset_detail::make_binary_expression<std::bit_and<>>(lhs, rhs);
+}
+
+template <typename L, typename R>
+  requires bitset_lazy_operands<L, R>
+auto operator|(L&& lhs, R&& rhs) {
+  return bitset_detail::make_binary_expression<std::bit_or<>>(lhs, rhs);
+}
+
+template <typename L, typename R>
+  requires bitset_lazy_operands<L, R>
+auto operator^(L&& lhs, R&& rhs) {
+  return bitset_detail::make_binary_expression<std::bit_xor<>>(lhs, rhs);
+}
+
+template <typename T>
+  requires bitset_lazy_operand<T> && (!is_static_bitset<std::remove_cvref_t<T>>)
+auto operator~(T&& value) {
+  auto operand = bitset_detail::as_expression(value);
+  return bitset_not_expression<decltype(operand)>(std::move(operand));
+}
+
+template <typename L, typename R>
+  requires bitset_operand<L> && bitset_operand<R> && (bitset_expression_type<L> || bitset_expression_type<R>)
+bool operator==(const L& lhs, const R& rhs) {
+  auto left = bitset_detail::as_expression(lhs);
+  auto right = bitset_detail::as_expression(rhs);
+  if (left.size() != right.size()) {
+    return false;
+  }
+  return left.for_each_word([&right, num = std::size_t(0)](uint64_t word, std::size_t count) mutable {
+    return word == right.get_word(num++, count);
+  });
+}
+
+template <typename L, typename R>
+  requires bitset_operand<L> && bitset_operand<R> && (bitset_expression_type<L> || bitset_expression_type<R>)
+bool operator!=(const L& lhs, const R& rhs) {
+  return !(lhs == rhs);
+}
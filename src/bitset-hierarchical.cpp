@@ -0,0 +1,133 @@
+#include "bitset-hierarchical.h"
+
+#include <bit>
+#include <utility>
+
+hierarchical_bitset::hierarchical_bitset(std::size_t size)
+    : _base(size, false) {
+  build();
+}
+
+hierarchical_bitset::hierarchical_bitset(const bitset::const_view& view)
+    : _base(view) {
+  build();
+}
+
+std::size_t hierarchical_bitset::size() const {
+  return _base.size();
+}
+
+bool hierarchical_bitset::empty() const {
+  return _base.empty();
+}
+
+bool hierarchical_bitset::test(std::size_t index) const {
+  return _base[index];
+}
+
+bool hierarchical_bitset::operator[](std::size_t index) const {
+  return _base[index];
+}
+
+hierarchical_bitset::reference hierarchical_bitset::operator[](std::size_t index) {
+  return {this, index};
+}
+
+void hierarchical_bitset::set(std::size_t index, bool value) {
+  word_type* data = _base.begin().word_pointer();
+  std::size_t num = index / word_size;
+  word_type before = data[num];
+  word_type mask = top_bit >> (index % word_size);
+  data[num] = value ? (before | mask) : (before & ~mask);
+
+  // Walk up while the changed word switches between zero and non-zero.
+  bool nonzero = data[num] != 0;
+  for (std::size_t level = 1; level < levels() && (before != 0) != nonzero; ++level) {
+    word_type& summary = _summaries[level - 1][num / word_size];
+    before = summary;
+    mask = top_bit >> (num % word_size);
+    summary = nonzero ? (summary | mask) : (summary & ~mask);
+    nonzero = summary != 0;
+    num /= word_size;
+  }
+}
+
+void hierarchical_bitset::reset(std::size_t index) {
+  set(index, false);
+}
+
+bool hierarchical_bitset::any() const {
+  return find(levels(), 0) != npos;
+}
+
+std::size_t hierarchical_bitset::count() const {
+  return _base.count();
+}
+
+std::size_t hierarchical_bitset::find_first() const {
+  return find(0, 0);
+}
+
+std::size_t hierarchical_bitset::find_next(std::size_t pos) const {
+  if (pos >= size()) {
+    return npos;
+  }
+  return find(0, pos + 1);
+}
+
+bitset::const_view hierarchical_bitset::base() const {
+  return _base;
+}
+
+hierarchical_bitset::operator bitset::const_view() const {
+  return _base;
+}
+
+void hierarchical_bitset::build() {
+  _summaries.clear();
+  for (std::size_t level = 0; (bits(level) + word_size - 1) / word_size > 1; ++level) {
+    std::size_t count = (bits(level) + word_size - 1) / word_size;
+    std::vector<word_type> summary((count + word_size - 1) / word_size, 0);
+    const word_type* data = words(level);
+    for (std::size_t num = 0; num < count; ++num) {
+      if (data[num] != 0) {
+        summary[num / word_size] |= top_bit >> (num % word_size);
+      }
+    }
+    _summaries.push_back(std::move(summary));
+  }
+}
+
+std::size_t hierarchical_bitset::levels() const {
+  return _summaries.size() + 1;
+}
+
+const hierarchical_bitset::word_type* hierarchical_bitset::words(std::size_t level) const {
+  return (level == 0) ? _base.begin().word_pointer() : _summaries[level - 1].data();
+}
+
+// Number of bits of `level`, that is, the number of words of the level below.
+std::size_t hierarchical_bitset::bits(std::size_t level) const {
+  return (level == 0) ? size() : (bits(level - 1) + word_size - 1) / word_size;
+}
+
+// First set bit at or after `index` in `level`. Level `levels()` stands for the bit of the single top word.
+std::size_t hierarchical_bitset::find(std::size_t level, std::size_t index) const {
+  if (index >= bits(level)) {
+    return npos;
+  }
+  if (level == levels()) {
+    return (words(level - 1)[index] != 0) ? index : npos;
+  }
+  const word_type* data = words(level);
+  std::size_t num = index / word_size;
+  word_type found = data[num] & (~word_type(0) >> (index % word_size));
+  if (found == 0) {
+    num = find(level + 1, num + 1);
+    if (num == npos) {
+      return npos;
+    }
+    found = data[num];
+  }
+  return num * word_size + std::countl_zero(found);
+}
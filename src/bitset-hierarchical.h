@@ -0,0 +1,111 @@
+#pragma once
+
+#include "bitset.h"
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Bitset with summary levels above its words: bit `i` of the first summary is set when word `i` of the bits is
+// non-zero, every further level summarizes the one below the same way, and the last level is a single word.
+// `find_next`, `any` and set-bit iteration use the summaries to jump over empty words in O(log64 size).
+//
+// Bits are changed one at a time through `set`, `reset` or `reference`, which keep the summaries up to date;
+// bulk reads go through `base()`, a `bitset::const_view` of the bits.
+class hierarchical_bitset {
+public:
+  using word_type = uint64_t;
+
+  static constexpr std::size_t npos = -1;
+  static constexpr std::size_t word_size = 64;
+
+  class reference {
+  public:
+    reference() = delete;
+
+    reference& operator=(bool bit) {
+      _owner->set(_index, bit);
+      return *this;
+    }
+
+    reference& operator=(const reference& other) {
+      return *this = bool(other);
+    }
+
+    operator bool() const {
+      return _owner->test(_index);
+    }
+
+    reference& flip() {
+      return *this = !bool(*this);
+    }
+
+  private:
+    friend class hierarchical_bitset;
+
+    reference(hierarchical_bitset* owner, std::size_t index)
+        : _owner(owner)
+        , _index(index) {}
+
+    hierarchical_bitset* _owner;
+    std::size_t _index;
+  };
+
+  hierarchical_bitset() = default;
+  explicit hierarchical_bitset(std::size_t size);
+  explicit hierarchical_bitset(const bitset::const_view& view);
+
+  std::size_t size() const;
+  bool empty() const;
+
+  bool test(std::size_t index) const;
+  bool operator[](std::size_t index) const;
+  reference operator[](std::size_t index);
+
+  void set(std::size_t index, bool value = true);
+  void reset(std::size_t index);
+
+  bool any() const;
+  std::size_t count() const;
+
+  std::size_t find_first() const;
+  // First set bit after `pos`, or `npos`.
+  std::size_t find_next(std::size_t pos) const;
+
+  template <typename Function>
+  void for_each(Function function) const;
+
+  bitset::const_view base() const;
+  operator bitset::const_view() const;
+
+private:
+  static constexpr word_type top_bit = word_type(1) << (word_size - 1);
+
+  void build();
+  std::size_t levels() const;
+  const word_type* words(std::size_t level) const;
+  std::size_t bits(std::size_t level) const;
+  std::size_t find(std::size_t level, std::size_t index) const;
+
+  bitset _base;
+  // `_summaries[k]` is level `k + 1`; level 0 is the words of `_base`.
+  std::vector<std::vector<word_type>> _summaries;
+};
+
+template <typename Function>
+void for_each_set_bit(const hierarchical_bitset& bs, Function function) {
+  bs.for_each(function);
+}
+
+template <typename Function>
+void hierarchical_bitset::for_each(Function function) const {
+  const word_type* data = words(0);
+  for (std::size_t num = find(1, 0); num != npos; num = find(1, num + 1)) {
+    for (word_type bits = data[num]; bits != 0;) {
+      int zeros = std::countl_zero(bits);
+      function(num * word_size + zeros);
+      bits ^= top_bit >> zeros;
+    }
+  }
+}
@@ -0,0 +1,129 @@
+#include "bitset-id-allocator.h"
+
+#include <algorithm>
+#include <bit>
+#include <functional>
+#include <thread>
+#include <utility>
+
+namespace {
+
+// Word where the calling thread's last `acquire` succeeded. It is shared by all allocators and only used as
+// a starting point, so it is reduced modulo the number of words. Threads start at scattered words.
+thread_local std::size_t hint = std::hash<std::thread::id>()(std::this_thread::get_id());
+
+} // namespace
+
+id_allocator::id_allocator(std::size_t capacity)
+    : _capacity(capacity) {
+  // Every level has at least one word, so an allocator without IDs has one full word.
+  std::size_t bits = capacity;
+  do {
+    std::size_t words = std::max<std::size_t>((bits + word_size - 1) / word_size, 1);
+    atomic_bitset level(bits);
+    if (level.word_count() < words) {
+      level = atomic_bitset(word_size, true);
+    } else if (bits % word_size != 0) {
+      level.word(words - 1).store(~word_type(0) >> (bits % word_size), std::memory_order_relaxed);
+    }
+    _levels.push_back(std::move(level));
+    bits = words;
+  } while (bits > 1);
+}
+
+std::size_t id_allocator::capacity() const {
+  return _capacity;
+}
+
+std::size_t id_allocator::acquire() {
+  std::size_t id;
+  if (claim(hint % _levels[0].word_count(), id)) {
+    return id;
+  }
+  std::size_t top = _levels.size() - 1;
+  while (true) {
+    std::size_t level = top;
+    std::size_t num = 0;
+    word_type bits = word(level, num).load(std::memory_order_acquire);
+    while (bits != ~word_type(0) && level != 0) {
+      num = num * word_size + std::countl_one(bits);
+      bits = word(--level, num).load(std::memory_order_acquire);
+    }
+
+    if (bits != ~word_type(0)) {
+      if (claim(num, id)) {
+        return id;
+      }
+    } else if (level == top) {
+      return npos;
+    } else {
+      publish_full(level, num);
+    }
+  }
+}
+
+void id_allocator::release(std::size_t id) {
+  std::size_t num = id / word_size;
+  word_type old = word(0, num).fetch_and(~(top_bit >> (id % word_size)), std::memory_order_acq_rel);
+  if (old == ~word_type(0)) {
+    publish_not_full(0, num);
+  }
+}
+
+bool id_allocator::is_acquired(std::size_t id) const {
+  return _levels[0].test(id, std::memory_order_acquire);
+}
+
+std::size_t id_allocator::count() const {
+  return (_capacity == 0) ? 0 : _levels[0].count(std::memory_order_relaxed);
+}
+
+std::atomic_ref<id_allocator::word_type> id_allocator::word(std::size_t level, std::size_t num) {
+  return _levels[level].word(num);
+}
+
+// Tries to take a free bit of leaf word `num`; fails only when the word is full.
+bool id_allocator::claim(std::size_t num, std::size_t& id) {
+  auto leaf = word(0, num);
+  word_type bits = leaf.load(std::memory_order_relaxed);
+  while (bits != ~word_type(0)) {
+    int free = std::countl_one(bits);
+    word_type updated = bits | (top_bit >> free);
+    if (leaf.compare_exchange_weak(bits, updated, std::memory_order_acq_rel, std::memory_order_relaxed)) {
+      if (updated == ~word_type(0)) {
+        publish_full(0, num);
+      }
+      hint = num;
+      id = num * word_size + free;
+      return true;
+    }
+  }
+  publish_full(0, num);
+  return false;
+}
+
+// Word `num` of `level` was seen full: set its summary bit, and clear it again if the word has meanwhile lost
+// a bit, since the thread that cleared that bit may have looked at the summary before it was set.
+void id_allocator::publish_full(std::size_t level, std::size_t num) {
+  if (level + 1 == _levels.size()) {
+    return;
+  }
+  word_type mask = top_bit >> (num % word_size);
+  word_type old = word(level + 1, num / word_size).fetch_or(mask);
+  if (old != ~word_type(0) && (old | mask) == ~word_type(0)) {
+    publish_full(level + 1, num / word_size);
+  }
+  if (word(level, num).load() != ~word_type(0)) {
+    publish_not_full(level, num);
+  }
+}
+
+void id_allocator::publish_not_full(std::size_t level, std::size_t num) {
+  if (level + 1 == _levels.size()) {
+    return;
+  }
+  word_type old = word(level + 1, num / word_size).fetch_and(~(top_bit >> (num % word_size)));
+  if (old == ~word_type(0)) {
+    publish_not_full(level + 1, num / word_size);
+  }
+}
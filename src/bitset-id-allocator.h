@@ -0,0 +1,54 @@
+#pragma once
+
+#include "bitset-atomic.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Lock-free allocator of IDs in [0, capacity). Taken IDs are ones in an `atomic_bitset`, and above it every
+// summary level, another `atomic_bitset`, has one bit per word of the level below, set when that word is full,
+// up to a single top word. `acquire` walks down from the top to a word with a zero bit in O(log64 capacity) and
+// claims the bit with a CAS; `release` clears it with a `fetch_and`. Both publish the changed fullness of a word
+// to the levels above.
+//
+// Summary bits are hints: a stale zero only costs a retry, and a thread that sets a summary bit re-checks the
+// word below afterwards, so a bit never stays set over a word that has a free ID. Each thread starts at the
+// word where its last `acquire` succeeded, so threads tend to work on different words.
+class id_allocator {
+public:
+  using word_type = uint64_t;
+
+  static constexpr std::size_t npos = -1;
+  static constexpr std::size_t word_size = 64;
+
+  explicit id_allocator(std::size_t capacity);
+
+  id_allocator(const id_allocator&) = delete;
+  id_allocator& operator=(const id_allocator&) = delete;
+
+  std::size_t capacity() const;
+
+  // Returns a free ID and marks it as taken, or `npos` if every ID is taken.
+  std::size_t acquire();
+  void release(std::size_t id);
+
+  bool is_acquired(std::size_t id) const;
+
+  // Number of taken IDs; only exact while no other thread acquires or releases.
+  std::size_t count() const;
+
+private:
+  static constexpr word_type top_bit = word_type(1) << (word_size - 1);
+
+  std::atomic_ref<word_type> word(std::size_t level, std::size_t num);
+
+  bool claim(std::size_t num, std::size_t& id);
+  void publish_full(std::size_t level, std::size_t num);
+  void publish_not_full(std::size_t level, std::size_t num);
+
+  std::size_t _capacity;
+  // `_levels[0]` holds one bit per ID. Bits past the end of every level are set, so they never look free.
+  std::vector<atomic_bitset> _levels;
+};
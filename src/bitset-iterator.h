@@ -1,10 +1,12 @@
 #pragma once
 #include "bitset-reference.h"
+#include "bitset-word.h"
 #include "bitset.h"
 
 #include <cstddef>
 #include <cstdint>
 #include <iterator>
+#include <type_traits>
 
 template <class T>
 class bitset_iterator {
@@ -13,11 +15,12 @@ public:
   using difference_type = std::ptrdiff_t;
   using reference = bitset_reference<T>;
   using iterator_category = std::random_access_iterator_tag;
-  using word_type = uint64_t;
-  static constexpr std::size_t word_size = 64;
+  using word_type = std::remove_const_t<T>;
+  static constexpr std::size_t word_size = bitset_word::bits<word_type>;
 
 private:
-  friend class bitset;
+  template <typename W>
+  friend class basic_bitset;
   template <typename U>
   friend class bitset_view;
   friend bitset_iterator<std::remove_const_t<T>>;
@@ -35,18 +38,29 @@ private:
     }
 
     if (size < word_size) {
-      ans &= ~((1ULL << (word_size - size)) - 1);
+      ans &= ~((word_type(1) << (word_size - size)) - 1);
     }
 
     return ans;
   }
 
+public:
+  bitset_iterator() = default;
+
+  // Iterator at bit `index` of `*word`, where `index` is below `word_size` and counts from the most significant
+  // bit. Containers built on words, such as static and memory-mapped bitsets, hand out views this way.
   bitset_iterator(T* word, size_t index) noexcept
       : _word{word}
       , _index{index} {}
 
-public:
-  bitset_iterator() = default;
+  // The word holding the bit and the bit's position in it, as passed to the constructor.
+  T* word_pointer() const noexcept {
+    return _word;
+  }
+
+  size_t bit_offset() const noexcept {
+    return _index;
+  }
 
   bitset_iterator(const bitset_iterator& o) = default;
 
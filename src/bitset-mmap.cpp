@@ -0,0 +1,201 @@
+#include "bitset-mmap.h"
+
+#include "bitset-serialization.h"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+mmap_bitset::mmap_bitset(mmap_bitset&& other) noexcept
+    : _fd(std::exchange(other._fd, -1))
+    , _writable(std::exchange(other._writable, false))
+    , _data(std::exchange(other._data, nullptr))
+    , _bytes(std::exchange(other._bytes, 0))
+    , _size(std::exchange(other._size, 0)) {}
+
+mmap_bitset& mmap_bitset::operator=(mmap_bitset&& other) noexcept {
+  if (this != &other) {
+    close();
+    _fd = std::exchange(other._fd, -1);
+    _writable = std::exchange(other._writable, false);
+    _data = std::exchange(other._data, nullptr);
+    _bytes = std::exchange(other._bytes, 0);
+    _size = std::exchange(other._size, 0);
+  }
+  return *this;
+}
+
+mmap_bitset::~mmap_bitset() {
+  close();
+}
+
+bool mmap_bitset::open(const std::string& path, mode value) {
+  close();
+  _writable = (value == mode::read_write);
+  _fd = ::open(path.c_str(), _writable ? O_RDWR : O_RDONLY);
+  struct stat info;
+  if (_fd < 0 || ::fstat(_fd, &info) != 0 || std::size_t(info.st_size) < sizeof(bitset_format::header) ||
+      !map(std::size_t(info.st_size))) {
+    close();
+    return false;
+  }
+
+  bitset_format::header header;
+  std::memcpy(&header, _data, sizeof(header));
+  if (!bitset_format::is_compatible(header) || !bitset_format::is_complete(header, _bytes)) {
+    // Not ours to flush.
+    _writable = false;
+    close();
+    return false;
+  }
+  _size = header.size;
+  return true;
+}
+
+bool mmap_bitset::create(const std::string& path, std::size_t size) {
+  close();
+  if (size > bitset_format::max_size) {
+    return false;
+  }
+  _writable = true;
+  _fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+  std::size_t bytes = bitset_format::serialized_bytes(size);
+  if (_fd < 0 || ::ftruncate(_fd, off_t(bytes)) != 0 || !map(bytes)) {
+    close();
+    return false;
+  }
+  _size = size;
+  return flush();
+}
+
+void mmap_bitset::close() {
+  if (_data != nullptr && _writable) {
+    flush();
+  }
+  unmap();
+  if (_fd >= 0) {
+    ::close(_fd);
+  }
+  _fd = -1;
+  _writable = false;
+  _size = 0;
+}
+
+bool mmap_bitset::is_open() const {
+  return _data != nullptr;
+}
+
+bool mmap_bitset::is_writable() const {
+  return _writable;
+}
+
+std::size_t mmap_bitset::size() const {
+  return _size;
+}
+
+bool mmap_bitset::empty() const {
+  return _size == 0;
+}
+
+bitset::view mmap_bitset::view() {
+  bitset::iterator first(words(), 0);
+  return {first, first + std::ptrdiff_t(_writable ? _size : 0)};
+}
+
+bitset::const_view mmap_bitset::view() const {
+  bitset::const_iterator first(words(), 0);
+  return {first, first + std::ptrdiff_t(_size)};
+}
+
+mmap_bitset::operator bitset::const_view() const {
+  return view();
+}
+
+bool mmap_bitset::verify() const {
+  bitset_format::header header;
+  std::memcpy(&header, _data, sizeof(header));
+  return header.size == _size && bitset_format::checksum(header, words()) == header.checksum;
+}
+
+bool mmap_bitset::flush() {
+  if (!_writable || _data == nullptr) {
+    return false;
+  }
+  bitset_format::header header = bitset_format::make_header(_size, words());
+  std::memcpy(_data, &header, sizeof(header));
+  return ::msync(_data, _bytes, MS_SYNC) == 0;
+}
+
+bool mmap_bitset::advise(advice value) {
+  int flag = MADV_NORMAL;
+  switch (value) {
+  case advice::normal:
+    break;
+  case advice::sequential:
+    flag = MADV_SEQUENTIAL;
+    break;
+  case advice::random:
+    flag = MADV_RANDOM;
+    break;
+  case advice::will_need:
+    flag = MADV_WILLNEED;
+    break;
+  }
+  return _data != nullptr && ::madvise(_data, _bytes, flag) == 0;
+}
+
+bool mmap_bitset::grow(std::size_t size) {
+  if (!_writable || _data == nullptr || size < _size || size > bitset_format::max_size) {
+    return false;
+  }
+  std::size_t tail = _size % bitset::word_size;
+  if (tail != 0) {
+    words()[_size / bitset::word_size] &= ~bitset::word_type(0) << (bitset::word_size - tail);
+  }
+
+  std::size_t old_words = bitset_format::word_count(_size);
+  std::size_t mapped_words = (_bytes - sizeof(bitset_format::header)) / sizeof(bitset::word_type);
+  std::size_t bytes = bitset_format::serialized_bytes(size);
+  if (bytes > _bytes) {
+    unmap();
+    if (::ftruncate(_fd, off_t(bytes)) != 0 || !map(bytes)) {
+      close();
+      return false;
+    }
+  }
+  // The file system zero-fills the extension, but a file may have been longer than its bitset.
+  std::size_t stale_end = std::min(mapped_words, bitset_format::word_count(size));
+  if (old_words < stale_end) {
+    std::fill(words() + old_words, words() + stale_end, 0);
+  }
+  _size = size;
+  return flush();
+}
+
+bool mmap_bitset::map(std::size_t bytes) {
+  int protection = _writable ? (PROT_READ | PROT_WRITE) : PROT_READ;
+  void* data = ::mmap(nullptr, bytes, protection, MAP_SHARED, _fd, 0);
+  if (data == MAP_FAILED) {
+    return false;
+  }
+  _data = static_cast<std::byte*>(data);
+  _bytes = bytes;
+  return true;
+}
+
+void mmap_bitset::unmap() {
+  if (_data != nullptr) {
+    ::munmap(_data, _bytes);
+  }
+  _data = nullptr;
+  _bytes = 0;
+}
+
+bitset::word_type* mmap_bitset::words() const {
+  return reinterpret_cast<bitset::word_type*>(_data + sizeof(bitset_format::header));
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "bitset.h"
+
+#include <cstddef>
+#include <string>
+
+// Bitset stored in a memory-mapped file in the layout of `bitset-serialization.h`, so that opening it takes
+// constant time and the words are paged in as they are used. Like file streams, the member functions that touch
+// the file report failure by returning false and leave the object closed.
+//
+// The header checksum is brought up to date by `flush()`, which a read-write bitset also calls when it is
+// closed. Views taken before `grow()` or `close()` are invalidated.
+class mmap_bitset {
+public:
+  enum class mode {
+    read_only,
+    read_write,
+  };
+
+  enum class advice {
+    normal,
+    sequential,
+    random,
+    will_need,
+  };
+
+  mmap_bitset() = default;
+
+  mmap_bitset(const mmap_bitset&) = delete;
+  mmap_bitset& operator=(const mmap_bitset&) = delete;
+
+  mmap_bitset(mmap_bitset&& other) noexcept;
+  mmap_bitset& operator=(mmap_bitset&& other) noexcept;
+
+  ~mmap_bitset();
+
+  // Maps an existing file. Its checksum is not verified; see `verify()`.
+  bool open(const std::string& path, mode value = mode::read_only);
+  // Creates or truncates `path` to hold `size` zero bits, at most `bitset_format::max_size`, and maps it for
+  // reading and writing.
+  bool create(const std::string& path, std::size_t size);
+  void close();
+
+  bool is_open() const;
+  bool is_writable() const;
+
+  std::size_t size() const;
+  bool empty() const;
+
+  // Empty unless the mapping is read-write, so that writes cannot reach read-only pages. A read-only bitset is
+  // read through the const overload or the conversion.
+  bitset::view view();
+  bitset::const_view view() const;
+  operator bitset::const_view() const;
+
+  bool verify() const;
+  bool flush();
+  bool advise(advice value);
+  // Extends the file to `size` bits, which are zero. Needs a read-write mapping.
+  bool grow(std::size_t size);
+
+private:
+  bool map(std::size_t bytes);
+  void unmap();
+
+  bitset::word_type* words() const;
+
+  int _fd = -1;
+  bool _writable = false;
+  std::byte* _data = nullptr;
+  std::size_t _bytes = 0;
+  std::size_t _size = 0;
+};
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <ranges>
+
+// Range of the indices of set bits in `size` bits starting `offset` bits into `data`. Words are visited one at a
+// time: the next index is found with `std::countl_zero`, and its bit is then cleared from a local copy.
+class bitset_ones : public std::ranges::view_interface<bitset_ones> {
+public:
+  using word_type = uint64_t;
+  static constexpr std::size_t word_size = 64;
+
+private:
+  // The words the range covers. Iterators keep their own copy, so they outlive the range they came from.
+  struct source {
+    const word_type* data = nullptr;
+    std::size_t offset = 0;
+    std::size_t size = 0;
+    std::size_t words = 0;
+
+    word_type word(std::size_t num) const {
+      word_type bits = data[num];
+      if (num == 0) {
+        bits &= ~word_type(0) >> offset;
+      }
+      std::size_t end = (offset + size) % word_size;
+      if (num + 1 == words && end != 0) {
+        bits &= ~word_type(0) << (word_size - end);
+      }
+      return bits;
+    }
+  };
+
+public:
+  // Indices are computed, not stored, so `operator*` returns by value and the iterator is only an input
+  // iterator to the legacy algorithms.
+  class iterator {
+  public:
+    using value_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using iterator_category = std::input_iterator_tag;
+    using iterator_concept = std::forward_iterator_tag;
+
+    iterator() = default;
+
+    std::size_t operator*() const {
+      return _num * word_size + std::countl_zero(_bits) - _source.offset;
+    }
+
+    iterator& operator++() {
+      _bits ^= top_bit >> std::countl_zero(_bits);
+      skip_empty();
+      return *this;
+    }
+
+    iterator operator++(int) {
+      iterator tmp = *this;
+      ++(*this);
+      return tmp;
+    }
+
+    friend bool operator==(const iterator& lhs, const iterator& rhs) {
+      return lhs._num == rhs._num && lhs._bits == rhs._bits;
+    }
+
+  private:
+    friend class bitset_ones;
+
+    iterator(const source& words, std::size_t num)
+        : _source(words)
+        , _num(num)
+        , _bits((num < words.words) ? words.word(num) : 0) {
+      skip_empty();
+    }
+
+    void skip_empty() {
+      while (_bits == 0 && _num < _source.words && ++_num < _source.words) {
+        _bits = _source.word(_num);
+      }
+    }
+
+    source _source;
+    std::size_t _num = 0;
+    word_type _bits = 0;
+  };
+
+  bitset_ones() = default;
+
+  bitset_ones(const word_type* data, std::size_t offset, std::size_t size)
+      : _source{data, offset, size, (size == 0) ? 0 : (offset + size + word_size - 1) / word_size} {}
+
+  iterator begin() const {
+    return {_source, 0};
+  }
+
+  iterator end() const {
+    return {_source, _source.words};
+  }
+
+  template <typename Function>
+  void for_each(Function function) const {
+    std::size_t words = _source.words;
+    if (words == 0) {
+      return;
+    }
+    visit(0, _source.word(0), function);
+    for (std::size_t num = 1; num + 1 < words; ++num) {
+      visit(num, _source.data[num], function);
+    }
+    if (words > 1) {
+      visit(words - 1, _source.word(words - 1), function);
+    }
+  }
+
+private:
+  static constexpr word_type top_bit = word_type(1) << (word_size - 1);
+
+  template <typename Function>
+  void visit(std::size_t num, word_type bits, Function& function) const {
+    std::size_t base = num * word_size - _source.offset;
+    while (bits != 0) {
+      int zeros = std::countl_zero(bits);
+      function(base + zeros);
+      bits ^= top_bit >> zeros;
+    }
+  }
+
+  source _source;
+};
@@ -0,0 +1,177 @@
+#include "bitset-parallel.h"
+
+#include <algorithm>
+#include <cstdint>
+
+bitset_executor::bitset_executor(std::size_t threads, std::size_t chunk_bits)
+    : _chunk_bits(std::max<std::size_t>(1, (chunk_bits + cache_line_bits - 1) / cache_line_bits) * cache_line_bits) {
+  for (std::size_t i = 1; i < threads; ++i) {
+    _threads.emplace_back([this] { worker(); });
+  }
+}
+
+bitset_executor::~bitset_executor() {
+  {
+    std::lock_guard lock(_mutex);
+    _shutdown = true;
+  }
+  _wake.notify_all();
+  for (std::thread& thread : _threads) {
+    thread.join();
+  }
+}
+
+std::size_t bitset_executor::concurrency() const {
+  return _threads.size() + 1;
+}
+
+void bitset_executor::and_assign(const bitset::view& dst, const bitset::const_view& src) {
+  run(dst, [&](std::size_t offset, std::size_t count) {
+    dst.subview(offset, count) &= src.subview(offset, count);
+    return true;
+  });
+}
+
+void bitset_executor::or_assign(const bitset::view& dst, const bitset::const_view& src) {
+  run(dst, [&](std::size_t offset, std::size_t count) {
+    dst.subview(offset, count) |= src.subview(offset, count);
+    return true;
+  });
+}
+
+void bitset_executor::xor_assign(const bitset::view& dst, const bitset::const_view& src) {
+  run(dst, [&](std::size_t offset, std::size_t count) {
+    dst.subview(offset, count) ^= src.subview(offset, count);
+    return true;
+  });
+}
+
+void bitset_executor::flip(const bitset::view& dst) {
+  run(dst, [&](std::size_t offset, std::size_t count) {
+    dst.subview(offset, count).flip();
+    return true;
+  });
+}
+
+std::size_t bitset_executor::count(const bitset::const_view& src) {
+  std::atomic<std::size_t> total = 0;
+  run(src, [&](std::size_t offset, std::size_t count) {
+    total.fetch_add(src.subview(offset, count).count(), std::memory_order_relaxed);
+    return true;
+  });
+  return total;
+}
+
+bool bitset_executor::any(const bitset::const_view& src) {
+  std::atomic<bool> found = false;
+  run(src, [&](std::size_t offset, std::size_t count) {
+    if (src.subview(offset, count).any()) {
+      found.store(true, std::memory_order_relaxed);
+      return false;
+    }
+    return true;
+  });
+  return found;
+}
+
+bool bitset_executor::all(const bitset::const_view& src) {
+  std::atomic<bool> missing = false;
+  run(src, [&](std::size_t offset, std::size_t count) {
+    if (!src.subview(offset, count).all()) {
+      missing.store(true, std::memory_order_relaxed);
+      return false;
+    }
+    return true;
+  });
+  return !missing;
+}
+
+bool bitset_executor::equal(const bitset::const_view& lhs, const bitset::const_view& rhs) {
+  if (lhs.size() != rhs.size()) {
+    return false;
+  }
+  std::atomic<bool> different = false;
+  run(lhs, [&](std::size_t offset, std::size_t count) {
+    if (lhs.subview(offset, count) != rhs.subview(offset, count)) {
+      different.store(true, std::memory_order_relaxed);
+      return false;
+    }
+    return true;
+  });
+  return !different;
+}
+
+// Chunk `k > 0` starts `_first + k * _chunk_bits` bits into the range, where `_first` is the offset of the first
+// cache line that begins inside it; chunk 0 covers everything before chunk 1.
+void bitset_executor::run(const bitset::const_view& range, const task& body) {
+  std::lock_guard submit(_submit);
+
+  std::size_t size = range.size();
+  auto address = reinterpret_cast<std::uintptr_t>(range.begin().word_pointer());
+  std::size_t line_bytes = cache_line_bits / 8;
+  std::size_t first =
+      (line_bytes - address % line_bytes) % line_bytes * 8 + cache_line_bits - range.begin().bit_offset();
+  first %= cache_line_bits;
+  std::size_t chunks = (size > first) ? 1 + (size - first - 1) / _chunk_bits : 1;
+
+  if (chunks == 1 || _threads.empty()) {
+    for (std::size_t k = 0; k < chunks; ++k) {
+      std::size_t begin = (k == 0) ? 0 : first + k * _chunk_bits;
+      std::size_t end = std::min(size, first + (k + 1) * _chunk_bits);
+      if (!body(begin, end - begin)) {
+        return;
+      }
+    }
+    return;
+  }
+
+  {
+    std::lock_guard lock(_mutex);
+    _body = &body;
+    _size = size;
+    _first = first;
+    _chunks = chunks;
+    _next.store(0, std::memory_order_relaxed);
+    _stop.store(false, std::memory_order_relaxed);
+    _active = _threads.size();
+    ++_generation;
+  }
+  _wake.notify_all();
+  work();
+
+  std::unique_lock lock(_mutex);
+  _done.wait(lock, [this] { return _active == 0; });
+  _body = nullptr;
+}
+
+void bitset_executor::work() {
+  while (!_stop.load(std::memory_order_relaxed)) {
+    std::size_t k = _next.fetch_add(1, std::memory_order_relaxed);
+    if (k >= _chunks) {
+      return;
+    }
+    std::size_t begin = (k == 0) ? 0 : _first + k * _chunk_bits;
+    std::size_t end = std::min(_size, _first + (k + 1) * _chunk_bits);
+    if (!(*_body)(begin, end - begin)) {
+      _stop.store(true, std::memory_order_relaxed);
+    }
+  }
+}
+
+void bitset_executor::worker() {
+  std::size_t seen = 0;
+  std::unique_lock lock(_mutex);
+  while (true) {
+    _wake.wait(lock, [&] { return _shutdown || _generation != seen; });
+    if (_shutdown) {
+      return;
+    }
+    seen = _generation;
+    lock.unlock();
+    work();
+    lock.lock();
+    if (--_active == 0) {
+      _done.notify_one();
+    }
+  }
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "bitset.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Runs bulk operations on large views on a fixed pool of threads. A view is split into chunks that start on
+// cache-line boundaries of its words, so no two threads write the same word: the partial words at the edges
+// belong to the first and last chunk. Threads claim chunks from a shared counter until none are left, and
+// reductions stop handing out chunks as soon as the answer is known.
+//
+// The calling thread takes part in every operation. Operations on one executor run one at a time; operands of
+// a binary operation must not overlap unless they are the same view.
+class bitset_executor {
+public:
+  static constexpr std::size_t cache_line_bits = 512;
+  static constexpr std::size_t default_chunk_bits = std::size_t(1) << 22;
+
+  explicit bitset_executor(
+      std::size_t threads = std::thread::hardware_concurrency(),
+      std::size_t chunk_bits = default_chunk_bits
+  );
+
+  bitset_executor(const bitset_executor&) = delete;
+  bitset_executor& operator=(const bitset_executor&) = delete;
+
+  ~bitset_executor();
+
+  // Number of threads that work on an operation, including the caller.
+  std::size_t concurrency() const;
+
+  void and_assign(const bitset::view& dst, const bitset::const_view& src);
+  void or_assign(const bitset::view& dst, const bitset::const_view& src);
+  void xor_assign(const bitset::view& dst, const bitset::const_view& src);
+  void flip(const bitset::view& dst);
+
+  std::size_t count(const bitset::const_view& src);
+  bool any(const bitset::const_view& src);
+  bool all(const bitset::const_view& src);
+  bool equal(const bitset::const_view& lhs, const bitset::const_view& rhs);
+
+private:
+  // Called with the offset and length of a chunk; returns false once the remaining chunks can be skipped.
+  using task = std::function<bool(std::size_t offset, std::size_t count)>;
+
+  void run(const bitset::const_view& range, const task& body);
+  void work();
+  void worker();
+
+  std::size_t _chunk_bits;
+  std::vector<std::thread> _threads;
+
+  std::mutex _submit;
+  std::mutex _mutex;
+  std::condition_variable _wake;
+  std::condition_variable _done;
+  std::size_t _generation = 0;
+  std::size_t _active = 0;
+  bool _shutdown = false;
+
+  const task* _body = nullptr;
+  std::size_t _size = 0;
+  std::size_t _first = 0;
+  std::size_t _chunks = 0;
+  std::atomic<std::size_t> _next = 0;
+  std::atomic<bool> _stop = false;
+};
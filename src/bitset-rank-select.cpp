@@ -0,0 +1,165 @@
+#include "bitset-rank-select.h"
+
+#include <algorithm>
+#include <bit>
+#include <utility>
+
+#if defined(__BMI2__)
+#include <immintrin.h>
+#endif
+
+namespace {
+
+constexpr std::size_t words_per_block = 8;
+constexpr std::size_t words_per_superblock = 32;
+constexpr std::size_t superblocks_per_upper = std::size_t(1) << 21;
+constexpr uint64_t block_count_mask = (uint64_t(1) << 10) - 1;
+
+// Index of the `rank`-th set bit of `word` in MSB-first order.
+std::size_t select_in_word(uint64_t word, std::size_t rank) {
+#if defined(__BMI2__)
+  std::size_t from_low = std::popcount(word) - 1 - rank;
+  return 63 - std::countr_zero(_pdep_u64(uint64_t(1) << from_low, word));
+#else
+  for (; rank != 0; --rank) {
+    word ^= (uint64_t(1) << 63) >> std::countl_zero(word);
+  }
+  return std::countl_zero(word);
+#endif
+}
+
+} // namespace
+
+rank_select_index::rank_select_index(const bitset::const_view& view)
+    : _size(view.size()) {
+  if (view.empty()) {
+    _superblocks.push_back(0);
+    _upper.push_back(0);
+    return;
+  }
+  if (view.begin().bit_offset() == 0) {
+    _data = view.begin().word_pointer();
+  } else {
+    _copy = bitset(view);
+  }
+
+  const word_type* words = data();
+  std::size_t word_count = (_size + word_size - 1) / word_size;
+  word_type tail_mask = (_size % word_size == 0) ? ~word_type(0) : ~word_type(0) << (word_size - _size % word_size);
+
+  std::size_t superblock_count = _size / superblock_bits + 1;
+  _superblocks.resize(superblock_count);
+  _upper.resize((superblock_count - 1) / superblocks_per_upper + 1);
+
+  for (std::size_t superblock = 0; superblock < superblock_count; ++superblock) {
+    if (superblock % superblocks_per_upper == 0) {
+      _upper[superblock / superblocks_per_upper] = _count;
+    }
+    uint64_t entry = uint64_t(_count - _upper[superblock / superblocks_per_upper]) << upper_shift;
+    std::size_t before = _count;
+
+    for (std::size_t block = 0; block < 4; ++block) {
+      std::size_t first = superblock * words_per_superblock + block * words_per_block;
+      std::size_t last = std::min(first + words_per_block, word_count);
+      std::size_t ones = 0;
+      for (std::size_t i = first; i < last; ++i) {
+        ones += std::popcount((i + 1 == word_count) ? words[i] & tail_mask : words[i]);
+      }
+      if (block < 3) {
+        entry |= uint64_t(ones) << (10 * block);
+      }
+      _count += ones;
+    }
+    _superblocks[superblock] = entry;
+
+    for (std::size_t k = (before + sample_rate - 1) / sample_rate * sample_rate; k < _count; k += sample_rate) {
+      _samples.push_back(uint32_t(superblock));
+    }
+  }
+}
+
+std::size_t rank_select_index::size() const {
+  return _size;
+}
+
+std::size_t rank_select_index::count() const {
+  return _count;
+}
+
+std::size_t rank_select_index::rank1(std::size_t pos) const {
+  pos = std::min(pos, _size);
+  std::size_t superblock = pos / superblock_bits;
+  std::size_t ans = ones_before(superblock);
+
+  uint64_t entry = _superblocks[superblock];
+  std::size_t block = pos / block_bits % 4;
+  for (std::size_t i = 0; i < block; ++i) {
+    ans += (entry >> (10 * i)) & block_count_mask;
+  }
+
+  const word_type* words = data();
+  for (std::size_t i = pos / block_bits * words_per_block; i < pos / word_size; ++i) {
+    ans += std::popcount(words[i]);
+  }
+  if (pos % word_size != 0) {
+    ans += std::popcount(words[pos / word_size] >> (word_size - pos % word_size));
+  }
+  return ans;
+}
+
+std::size_t rank_select_index::rank0(std::size_t pos) const {
+  pos = std::min(pos, _size);
+  return pos - rank1(pos);
+}
+
+std::size_t rank_select_index::select1(std::size_t k) const {
+  if (k >= _count) {
+    return npos;
+  }
+  std::size_t sample = k / sample_rate;
+  std::size_t low = _samples[sample];
+  std::size_t high = (sample + 1 < _samples.size()) ? _samples[sample + 1] + 1 : _superblocks.size();
+  while (high - low > 1) {
+    std::size_t middle = low + (high - low) / 2;
+    if (ones_before(middle) <= k) {
+      low = middle;
+    } else {
+      high = middle;
+    }
+  }
+
+  std::size_t rest = k - ones_before(low);
+  uint64_t entry = _superblocks[low];
+  std::size_t block = 0;
+  for (; block < 3; ++block) {
+    std::size_t ones = (entry >> (10 * block)) & block_count_mask;
+    if (rest < ones) {
+      break;
+    }
+    rest -= ones;
+  }
+
+  const word_type* words = data();
+  std::size_t i = low * words_per_superblock + block * words_per_block;
+  for (;; ++i) {
+    std::size_t ones = std::popcount(words[i]);
+    if (rest < ones) {
+      break;
+    }
+    rest -= ones;
+  }
+  return i * word_size + select_in_word(words[i], rest);
+}
+
+std::size_t rank_select_index::memory_usage() const {
+  return _upper.size() * sizeof(uint64_t) + _superblocks.size() * sizeof(uint64_t) +
+         _samples.size() * sizeof(uint32_t);
+}
+
+const rank_select_index::word_type* rank_select_index::data() const {
+  return _copy.empty() ? _data : std::as_const(_copy).begin().word_pointer();
+}
+
+std::size_t rank_select_index::ones_before(std::size_t superblock) const {
+  return _upper[superblock / superblocks_per_upper] + (_superblocks[superblock] >> upper_shift);
+}
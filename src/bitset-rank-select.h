@@ -0,0 +1,55 @@
+#pragma once
+
+#include "bitset.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Constant-time rank and select over an immutable bitset, in the layout of poppy: one 64-bit entry per
+// 2048-bit superblock keeps the number of ones before it (relative to its 2^32-bit upper block) in the high
+// 32 bits and the counts of its first three 512-bit blocks in 10-bit fields below. That is 3.125% on top of the
+// bits themselves; select adds a sample per 8192 ones.
+//
+// The index refers to the words of the view it is built from, which must outlive it and stay unchanged. Views
+// that do not start at a word boundary are copied.
+class rank_select_index {
+public:
+  using word_type = uint64_t;
+
+  static constexpr std::size_t npos = -1;
+  static constexpr std::size_t word_size = 64;
+
+  rank_select_index() = default;
+  explicit rank_select_index(const bitset::const_view& view);
+
+  std::size_t size() const;
+  std::size_t count() const;
+
+  // Number of ones (zeros) in [0, pos).
+  std::size_t rank1(std::size_t pos) const;
+  std::size_t rank0(std::size_t pos) const;
+
+  // Position of the `k`-th one, counting from 0, or `npos` if there are at most `k` ones.
+  std::size_t select1(std::size_t k) const;
+
+  // Bytes used by the index on top of the bits it refers to.
+  std::size_t memory_usage() const;
+
+private:
+  static constexpr std::size_t block_bits = 512;
+  static constexpr std::size_t superblock_bits = 2048;
+  static constexpr std::size_t upper_shift = 32;
+  static constexpr std::size_t sample_rate = 8192;
+
+  const word_type* data() const;
+  std::size_t ones_before(std::size_t superblock) const;
+
+  bitset _copy;
+  const word_type* _data = nullptr;
+  std::size_t _size = 0;
+  std::size_t _count = 0;
+  std::vector<uint64_t> _upper;
+  std::vector<uint64_t> _superblocks;
+  std::vector<uint32_t> _samples;
+};
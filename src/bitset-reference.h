@@ -1,5 +1,6 @@
 #pragma once
 #include <bitset-iterator.h>
+#include <bitset-word.h>
 
 #include <cstddef>
 #include <cstdint>
@@ -10,7 +11,7 @@ class bitset_reference {
 public:
   using value_type = bool;
   using word_type = T;
-  static constexpr std::size_t word_size = 64;
+  static constexpr std::size_t word_size = bitset_word::bits<std::remove_const_t<T>>;
 
 private:
   size_t index;
@@ -18,7 +19,8 @@ private:
 
   template <typename U>
   friend class bitset_iterator;
-  friend class bitset;
+  template <typename W>
+  friend class basic_bitset;
   template <typename U>
   friend class bitset_view;
   friend class bitset_reference<std::remove_const_t<T>>;
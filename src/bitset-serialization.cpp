@@ -0,0 +1,60 @@
+#include "bitset-serialization.h"
+
+namespace bitset_format {
+
+namespace {
+
+constexpr uint64_t offset_basis = 0xcbf29ce484222325;
+constexpr uint64_t prime = 0x100000001b3;
+
+} // namespace
+
+header make_header(std::size_t size, const word_type* words, word_type last_mask) {
+  header result = {magic, version, 64, native_flags, size, 0, 0};
+  result.checksum = checksum(result, words, last_mask);
+  return result;
+}
+
+bool is_compatible(const header& value) {
+  return value.magic == magic && value.version == version && value.word_size == 64 && value.flags == native_flags &&
+         value.size <= max_size;
+}
+
+bool is_complete(const header& value, std::size_t bytes) {
+  return bytes >= sizeof(header) && (bytes - sizeof(header)) / sizeof(word_type) >= word_count(value.size);
+}
+
+std::size_t word_count(std::size_t size) {
+  return size / 64 + ((size % 64 != 0) ? 1 : 0);
+}
+
+std::size_t serialized_bytes(std::size_t size) {
+  return sizeof(header) + word_count(size) * sizeof(word_type);
+}
+
+uint64_t checksum(const header& value, const word_type* words, word_type last_mask) {
+  std::size_t count = word_count(value.size);
+  uint64_t lanes[4] = {offset_basis, offset_basis ^ 1, offset_basis ^ 2, offset_basis ^ 3};
+  std::size_t body = (count == 0) ? 0 : count - 1;
+  std::size_t i = 0;
+  for (; i + 4 <= body; i += 4) {
+    for (std::size_t j = 0; j < 4; ++j) {
+      lanes[j] = (lanes[j] ^ words[i + j]) * prime;
+    }
+  }
+  for (; i < body; ++i) {
+    lanes[i % 4] = (lanes[i % 4] ^ words[i]) * prime;
+  }
+  if (count != 0) {
+    lanes[i % 4] = (lanes[i % 4] ^ (words[i] & last_mask)) * prime;
+  }
+
+  uint64_t layout = uint64_t(value.version) << 16 | uint64_t(value.word_size) << 8 | value.flags;
+  uint64_t result = (((offset_basis ^ layout) * prime) ^ value.size) * prime;
+  for (uint64_t lane : lanes) {
+    result = (result ^ lane) * prime;
+  }
+  return result;
+}
+
+} // namespace bitset_format
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+// Binary layout of a serialized bitset: a 32-byte header followed by the words in native byte order, with the
+// bits past the end of the last word cleared. The words start 32 bytes into the data, so a buffer that is 8-byte
+// aligned can be used in place.
+namespace bitset_format {
+
+using word_type = uint64_t;
+
+inline constexpr uint32_t magic = 0x54455342; // "BSET" in little-endian order.
+inline constexpr uint16_t version = 1;
+
+// Bits are stored from the most significant end of each word.
+inline constexpr uint8_t msb_first = 1;
+inline constexpr uint8_t big_endian = 2;
+inline constexpr uint8_t native_flags = msb_first | ((std::endian::native == std::endian::big) ? big_endian : 0);
+
+struct header {
+  uint32_t magic;
+  uint16_t version;
+  uint8_t word_size;
+  uint8_t flags;
+  uint64_t size;
+  uint64_t checksum;
+  uint64_t reserved;
+};
+
+static_assert(sizeof(header) == 32);
+
+// Longest bitset the format describes. The words of one this long can be counted, sized in bytes and spanned by
+// a view without overflow, so a size read from untrusted data is checked against it before any of these.
+inline constexpr std::size_t max_size = PTRDIFF_MAX;
+
+// A header for `size` bits stored in `words`, with its checksum filled in. `last_mask` is as for `checksum`.
+header make_header(std::size_t size, const word_type* words, word_type last_mask = ~word_type(0));
+
+// Checks everything except the checksum and the length of the data, including that the size is at most
+// `max_size`.
+bool is_compatible(const header& value);
+
+// Whether `bytes` bytes of data, header included, hold every word of `value`.
+bool is_complete(const header& value, std::size_t bytes);
+
+std::size_t word_count(std::size_t size);
+std::size_t serialized_bytes(std::size_t size);
+
+// Hash of the version, word size, flags and size of `value` and of its `word_count(value.size)` words, so that a
+// corrupted length fails the check as well as corrupted bits. The words are hashed in four interleaved FNV-style
+// lanes, so that hashing keeps up with reading. `last_mask` is applied to the last word, which lets a bitset be
+// hashed without clearing its unused bits first. The checksum field of `value` is ignored.
+uint64_t checksum(const header& value, const word_type* words, word_type last_mask = ~word_type(0));
+
+} // namespace bitset_format
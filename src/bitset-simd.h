@@ -0,0 +1,424 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace bitset_simd {
+
+using word_type = uint64_t;
+static constexpr std::size_t word_size = 64;
+
+#if defined(__AVX512F__)
+inline constexpr std::size_t native_width = 8;
+#elif defined(__AVX2__)
+inline constexpr std::size_t native_width = 4;
+#elif defined(__SSE2__) || defined(__ARM_NEON)
+inline constexpr std::size_t native_width = 2;
+#else
+inline constexpr std::size_t native_width = 1;
+#endif
+
+template <std::size_t Width>
+struct block_type {
+  typedef word_type type __attribute__((vector_size(Width * sizeof(word_type))));
+};
+
+template <std::size_t Width>
+using block = typename block_type<Width>::type;
+
+static_assert(sizeof(block<native_width>) == native_width * sizeof(word_type));
+
+template <std::size_t Width>
+[[gnu::always_inline]] inline block<Width> load(const word_type* words) {
+  block<Width> result;
+  std::memcpy(&result, words, sizeof(result));
+  return result;
+}
+
+template <std::size_t Width>
+[[gnu::always_inline]] inline block<Width> load_shifted(const word_type* words, std::size_t shift) {
+  return (load<Width>(words) << shift) | (load<Width>(words + 1) >> (word_size - shift));
+}
+
+template <std::size_t Width>
+[[gnu::always_inline]] inline void store(word_type* words, const block<Width>& value) {
+  std::memcpy(words, &value, sizeof(value));
+}
+
+template <std::size_t Width>
+[[gnu::always_inline]] inline block<Width> broadcast(word_type word) {
+  return block<Width>{} + word;
+}
+
+template <std::size_t Width>
+[[gnu::always_inline]] inline word_type reduce_or(const block<Width>& value) {
+  word_type result = 0;
+  for (std::size_t i = 0; i < Width; ++i) {
+    result |= value[i];
+  }
+  return result;
+}
+
+struct and_operation {
+  template <typename T>
+  [[gnu::always_inline]] T operator()(const T& a, const T& b) const {
+    return a & b;
+  }
+};
+
+struct or_operation {
+  template <typename T>
+  [[gnu::always_inline]] T operator()(const T& a, const T& b) const {
+    return a | b;
+  }
+};
+
+struct xor_operation {
+  template <typename T>
+  [[gnu::always_inline]] T operator()(const T& a, const T& b) const {
+    return a ^ b;
+  }
+};
+
+struct andnot_operation {
+  template <typename T>
+  [[gnu::always_inline]] T operator()(const T& a, const T& b) const {
+    return a & ~b;
+  }
+};
+
+struct flip_operation {
+  template <typename T>
+  [[gnu::always_inline]] T operator()(const T& a) const {
+    return ~a;
+  }
+};
+
+struct set_operation {
+  template <typename T>
+  [[gnu::always_inline]] T operator()(const T& /*a*/) const {
+    return ~T{};
+  }
+};
+
+struct reset_operation {
+  template <typename T>
+  [[gnu::always_inline]] T operator()(const T& /*a*/) const {
+    return T{};
+  }
+};
+
+// `dst[i] = operation(dst[i], src'[i])` for `count` whole words, where `src'` is the bit sequence starting
+// `shift` bits into `src`. With a non-zero shift `src[count]` is read as well. The shift is tested once: aligned
+// operands take a plain word loop, and the scalar part of the misaligned loop carries the previous source word
+// into the next funnel shift instead of loading it again.
+template <std::size_t Width, typename Function>
+[[gnu::always_inline]] inline void binary(
+    word_type* dst,
+    const word_type* src,
+    std::size_t count,
+    std::size_t shift,
+    Function operation
+) {
+  std::size_t i = 0;
+  if (shift == 0) {
+    for (; i + Width <= count; i += Width) {
+      store<Width>(dst + i, operation(load<Width>(dst + i), load<Width>(src + i)));
+    }
+    for (; i < count; ++i) {
+      dst[i] = operation(dst[i], src[i]);
+    }
+    return;
+  }
+  if constexpr (Width > 1) {
+    for (; i + Width <= count; i += Width) {
+      store<Width>(dst + i, operation(load<Width>(dst + i), load_shifted<Width>(src + i, shift)));
+    }
+  }
+  word_type current = src[i];
+  for (; i < count; ++i) {
+    word_type next = src[i + 1];
+    dst[i] = operation(dst[i], (current << shift) | (next >> (word_size - shift)));
+    current = next;
+  }
+}
+
+template <std::size_t Width, typename Function>
+[[gnu::always_inline]] inline void unary(word_type* dst, std::size_t count, Function operation) {
+  std::size_t i = 0;
+  for (; i + Width <= count; i += Width) {
+    store<Width>(dst + i, operation(load<Width>(dst + i)));
+  }
+  for (; i < count; ++i) {
+    dst[i] = operation(dst[i]);
+  }
+}
+
+template <std::size_t Width>
+[[gnu::always_inline]] inline std::size_t popcount(const block<Width>& value) {
+  std::size_t result = 0;
+  for (std::size_t i = 0; i < Width; ++i) {
+    result += std::popcount(value[i]);
+  }
+  return result;
+}
+
+// Carry-save adder: adds `a` and `b` to `low` bit by bit, leaving the sum bits in `low` and the carries in `high`.
+template <std::size_t Width>
+[[gnu::always_inline]] inline void
+add(block<Width>& high, block<Width>& low, const block<Width>& a, const block<Width>& b) {
+  block<Width> partial = low ^ a;
+  high = (low & a) | (partial & b);
+  low = partial ^ b;
+}
+
+// Harley-Seal population count of the blocks `load(i)`, `load(i + Width)`, ... in whole chunks of 16 blocks
+// from `i`, which it advances past them. A tree of carry-save adders folds every chunk into one block of
+// sixteens, so only one block in 16 goes through popcount.
+template <std::size_t Width, typename Load>
+[[gnu::always_inline]] inline std::size_t harley_seal(std::size_t& i, std::size_t count, Load load) {
+  constexpr std::size_t chunk = 16 * Width;
+  block<Width> ones{};
+  block<Width> twos{};
+  block<Width> fours{};
+  block<Width> eights{};
+  block<Width> twos_a, twos_b, fours_a, fours_b, eights_a, eights_b, sixteens;
+  std::size_t sixteens_count = 0;
+  for (; i + chunk <= count; i += chunk) {
+    add<Width>(twos_a, ones, load(i), load(i + Width));
+    add<Width>(twos_b, ones, load(i + 2 * Width), load(i + 3 * Width));
+    add<Width>(fours_a, twos, twos_a, twos_b);
+    add<Width>(twos_a, ones, load(i + 4 * Width), load(i + 5 * Width));
+    add<Width>(twos_b, ones, load(i + 6 * Width), load(i + 7 * Width));
+    add<Width>(fours_b, twos, twos_a, twos_b);
+    add<Width>(eights_a, fours, fours_a, fours_b);
+    add<Width>(twos_a, ones, load(i + 8 * Width), load(i + 9 * Width));
+    add<Width>(twos_b, ones, load(i + 10 * Width), load(i + 11 * Width));
+    add<Width>(fours_a, twos, twos_a, twos_b);
+    add<Width>(twos_a, ones, load(i + 12 * Width), load(i + 13 * Width));
+    add<Width>(twos_b, ones, load(i + 14 * Width), load(i + 15 * Width));
+    add<Width>(fours_b, twos, twos_a, twos_b);
+    add<Width>(eights_b, fours, fours_a, fours_b);
+    add<Width>(sixteens, eights, eights_a, eights_b);
+    sixteens_count += popcount<Width>(sixteens);
+  }
+  return 16 * sixteens_count + 8 * popcount<Width>(eights) + 4 * popcount<Width>(fours) +
+         2 * popcount<Width>(twos) + popcount<Width>(ones);
+}
+
+template <std::size_t Width>
+[[gnu::always_inline]] inline std::size_t count(const word_type* src, std::size_t count) {
+  std::size_t i = 0;
+  std::size_t result = harley_seal<Width>(i, count, [src](std::size_t j) { return load<Width>(src + j); });
+  for (; i < count; ++i) {
+    result += std::popcount(src[i]);
+  }
+  return result;
+}
+
+// Ones in `operation(lhs[i], rhs'[i])` for `count` whole words, with `rhs'` read as the source of `binary`.
+template <std::size_t Width, typename Function>
+[[gnu::always_inline]] inline std::size_t count_binary(
+    const word_type* lhs,
+    const word_type* rhs,
+    std::size_t count,
+    std::size_t shift,
+    Function operation
+) {
+  std::size_t i = 0;
+  std::size_t result = 0;
+  if (shift == 0) {
+    result = harley_seal<Width>(i, count, [=](std::size_t j) {
+      return operation(load<Width>(lhs + j), load<Width>(rhs + j));
+    });
+    for (; i < count; ++i) {
+      result += std::popcount(operation(lhs[i], rhs[i]));
+    }
+    return result;
+  }
+  result = harley_seal<Width>(i, count, [=](std::size_t j) {
+    return operation(load<Width>(lhs + j), load_shifted<Width>(rhs + j, shift));
+  });
+  word_type current = rhs[i];
+  for (; i < count; ++i) {
+    word_type next = rhs[i + 1];
+    result += std::popcount(operation(lhs[i], (current << shift) | (next >> (word_size - shift))));
+    current = next;
+  }
+  return result;
+}
+
+// Whether `operation(lhs[i], rhs'[i])` has a one in any of `count` whole words. Chunks are checked as in `match`.
+template <std::size_t Width, typename Function>
+[[gnu::always_inline]] inline bool any_binary(
+    const word_type* lhs,
+    const word_type* rhs,
+    std::size_t count,
+    std::size_t shift,
+    Function operation
+) {
+  constexpr std::size_t chunk = 8 * Width;
+  std::size_t i = 0;
+  if (shift == 0) {
+    for (; i + chunk <= count; i += chunk) {
+      block<Width> found{};
+      for (std::size_t j = 0; j < chunk; j += Width) {
+        found |= operation(load<Width>(lhs + i + j), load<Width>(rhs + i + j));
+      }
+      if (reduce_or<Width>(found) != 0) {
+        return true;
+      }
+    }
+    for (; i < count; ++i) {
+      if (operation(lhs[i], rhs[i]) != 0) {
+        return true;
+      }
+    }
+    return false;
+  }
+  if constexpr (Width > 1) {
+    for (; i + chunk <= count; i += chunk) {
+      block<Width> found{};
+      for (std::size_t j = 0; j < chunk; j += Width) {
+        found |= operation(load<Width>(lhs + i + j), load_shifted<Width>(rhs + i + j, shift));
+      }
+      if (reduce_or<Width>(found) != 0) {
+        return true;
+      }
+    }
+  }
+  word_type current = rhs[i];
+  for (; i < count; ++i) {
+    word_type next = rhs[i + 1];
+    if (operation(lhs[i], (current << shift) | (next >> (word_size - shift))) != 0) {
+      return true;
+    }
+    current = next;
+  }
+  return false;
+}
+
+// Checks that every word equals `pattern`. Blocks are accumulated a chunk at a time so that a mismatch near
+// the front does not scan the whole range.
+template <std::size_t Width>
+[[gnu::always_inline]] inline bool match(const word_type* src, std::size_t count, word_type pattern) {
+  constexpr std::size_t chunk = 8 * Width;
+  std::size_t i = 0;
+  const block<Width> expected = broadcast<Width>(pattern);
+  for (; i + chunk <= count; i += chunk) {
+    block<Width> diff{};
+    for (std::size_t j = 0; j < chunk; j += Width) {
+      diff |= load<Width>(src + i + j) ^ expected;
+    }
+    if (reduce_or<Width>(diff) != 0) {
+      return false;
+    }
+  }
+  for (; i < count; ++i) {
+    if (src[i] != pattern) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Returns the index of the first word that differs from `pattern`, or `count` if there is none. Whole chunks
+// equal to the pattern are skipped with block compares before the scalar loop locates the word.
+template <std::size_t Width>
+[[gnu::always_inline]] inline std::size_t find(const word_type* src, std::size_t count, word_type pattern) {
+  constexpr std::size_t chunk = 4 * Width;
+  std::size_t i = 0;
+  const block<Width> expected = broadcast<Width>(pattern);
+  for (; i + chunk <= count; i += chunk) {
+    block<Width> diff{};
+    for (std::size_t j = 0; j < chunk; j += Width) {
+      diff |= load<Width>(src + i + j) ^ expected;
+    }
+    if (reduce_or<Width>(diff) != 0) {
+      break;
+    }
+  }
+  for (; i < count; ++i) {
+    if (src[i] != pattern) {
+      return i;
+    }
+  }
+  return count;
+}
+
+// Returns the index of the last word that differs from `pattern`, or `count` if there is none.
+template <std::size_t Width>
+[[gnu::always_inline]] inline std::size_t find_last(const word_type* src, std::size_t count, word_type pattern) {
+  constexpr std::size_t chunk = 4 * Width;
+  std::size_t i = count;
+  const block<Width> expected = broadcast<Width>(pattern);
+  for (; i >= chunk; i -= chunk) {
+    block<Width> diff{};
+    for (std::size_t j = i - chunk; j < i; j += Width) {
+      diff |= load<Width>(src + j) ^ expected;
+    }
+    if (reduce_or<Width>(diff) != 0) {
+      break;
+    }
+  }
+  for (; i > 0; --i) {
+    if (src[i - 1] != pattern) {
+      return i - 1;
+    }
+  }
+  return count;
+}
+
+// Compares `count` whole words of `lhs` against the bit sequence starting `shift` bits into `rhs`. As in
+// `binary`, aligned operands are compared with plain loads and the misaligned scalar loop carries a word.
+template <std::size_t Width>
+[[gnu::always_inline]] inline bool equal(
+    const word_type* lhs,
+    const word_type* rhs,
+    std::size_t count,
+    std::size_t shift
+) {
+  constexpr std::size_t chunk = 8 * Width;
+  std::size_t i = 0;
+  if (shift == 0) {
+    for (; i + chunk <= count; i += chunk) {
+      block<Width> diff{};
+      for (std::size_t j = 0; j < chunk; j += Width) {
+        diff |= load<Width>(lhs + i + j) ^ load<Width>(rhs + i + j);
+      }
+      if (reduce_or<Width>(diff) != 0) {
+        return false;
+      }
+    }
+    for (; i < count; ++i) {
+      if (lhs[i] != rhs[i]) {
+        return false;
+      }
+    }
+    return true;
+  }
+  if constexpr (Width > 1) {
+    for (; i + chunk <= count; i += chunk) {
+      block<Width> diff{};
+      for (std::size_t j = 0; j < chunk; j += Width) {
+        diff |= load<Width>(lhs + i + j) ^ load_shifted<Width>(rhs + i + j, shift);
+      }
+      if (reduce_or<Width>(diff) != 0) {
+        return false;
+      }
+    }
+  }
+  word_type current = rhs[i];
+  for (; i < count; ++i) {
+    word_type next = rhs[i + 1];
+    if (lhs[i] != ((current << shift) | (next >> (word_size - shift)))) {
+      return false;
+    }
+    current = next;
+  }
+  return true;
+}
+
+} // namespace bitset_simd
@@ -0,0 +1,273 @@
+#pragma once
+
+#include "bitset-text.h"
+#include "bitset.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+// Bitset of `N` bits, with the size fixed at compile time and the words stored in the object. Everything except
+// the conversions to views is constexpr. The loops run over a constant number of words, so the compiler can
+// unroll them.
+//
+// The bits past `N` in the last word are always zero. They can only be changed through a view, which does not
+// reach them.
+template <std::size_t N>
+class static_bitset {
+public:
+  using word_type = uint64_t;
+  using value_type = bool;
+  using view = bitset::view;
+  using const_view = bitset::const_view;
+
+  static constexpr std::size_t npos = bitset::npos;
+  static constexpr std::size_t word_size = 64;
+  static constexpr std::size_t word_count = (N + word_size - 1) / word_size;
+
+  constexpr static_bitset() = default;
+
+  // Like the `bitset` constructor, reads every character other than '1' as 0. Bits without a character are 0.
+  constexpr explicit static_bitset(std::string_view str) {
+    std::size_t length = std::min(N, str.size());
+    if (std::is_constant_evaluated()) {
+      for (std::size_t i = 0; i < length; ++i) {
+        set(i, str[i] == '1');
+      }
+    } else {
+      for (std::size_t i = 0; i * word_size < length; ++i) {
+        _words[i] = bitset_text::parse_word(str.data() + i * word_size, std::min(word_size, length - i * word_size));
+      }
+    }
+  }
+
+  static constexpr std::size_t size() {
+    return N;
+  }
+
+  static constexpr bool empty() {
+    return N == 0;
+  }
+
+  constexpr bool operator[](std::size_t index) const {
+    return test(index);
+  }
+
+  constexpr bool test(std::size_t index) const {
+    return (_words[index / word_size] & bit(index)) != 0;
+  }
+
+  constexpr static_bitset& set(std::size_t index, bool value = true) {
+    word_type& word = _words[index / word_size];
+    word = value ? (word | bit(index)) : (word & ~bit(index));
+    return *this;
+  }
+
+  constexpr static_bitset& reset(std::size_t index) {
+    return set(index, false);
+  }
+
+  constexpr static_bitset& flip(std::size_t index) {
+    _words[index / word_size] ^= bit(index);
+    return *this;
+  }
+
+  constexpr static_bitset& set() {
+    _words.fill(~word_type(0));
+    clear_tail();
+    return *this;
+  }
+
+  constexpr static_bitset& reset() {
+    _words.fill(0);
+    return *this;
+  }
+
+  constexpr static_bitset& flip() {
+    for (word_type& word : _words) {
+      word = ~word;
+    }
+    clear_tail();
+    return *this;
+  }
+
+  constexpr std::size_t count() const {
+    std::size_t ans = 0;
+    for (word_type word : _words) {
+      ans += std::popcount(word);
+    }
+    return ans;
+  }
+
+  constexpr bool all() const {
+    for (std::size_t i = 0; i + 1 < word_count; ++i) {
+      if (_words[i] != ~word_type(0)) {
+        return false;
+      }
+    }
+    return word_count == 0 || _words[word_count - 1] == tail_mask;
+  }
+
+  constexpr bool any() const {
+    for (word_type word : _words) {
+      if (word != 0) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  constexpr bool none() const {
+    return !any();
+  }
+
+  constexpr std::size_t find_first() const {
+    return find_from(0);
+  }
+
+  constexpr std::size_t find_next(std::size_t pos) const {
+    return (pos < N) ? find_from(pos + 1) : npos;
+  }
+
+  constexpr static_bitset& operator&=(const static_bitset& other) {
+    for (std::size_t i = 0; i < word_count; ++i) {
+      _words[i] &= other._words[i];
+    }
+    return *this;
+  }
+
+  constexpr static_bitset& operator|=(const static_bitset& other) {
+    for (std::size_t i = 0; i < word_count; ++i) {
+      _words[i] |= other._words[i];
+    }
+    return *this;
+  }
+
+  constexpr static_bitset& operator^=(const static_bitset& other) {
+    for (std::size_t i = 0; i < word_count; ++i) {
+      _words[i] ^= other._words[i];
+    }
+    return *this;
+  }
+
+  friend constexpr static_bitset operator&(static_bitset lhs, const static_bitset& rhs) {
+    return lhs &= rhs;
+  }
+
+  friend constexpr static_bitset operator|(static_bitset lhs, const static_bitset& rhs) {
+    return lhs |= rhs;
+  }
+
+  friend constexpr static_bitset operator^(static_bitset lhs, const static_bitset& rhs) {
+    return lhs ^= rhs;
+  }
+
+  friend constexpr static_bitset operator~(static_bitset bs) {
+    return bs.flip();
+  }
+
+  friend constexpr bool operator==(const static_bitset& lhs, const static_bitset& rhs) = default;
+
+  // The words, with the first bit in the most significant bit of the first word.
+  constexpr const std::array<word_type, word_count>& words() const {
+    return _words;
+  }
+
+  view subview(std::size_t offset = 0, std::size_t count = npos) {
+    return static_cast<view>(*this).subview(offset, count);
+  }
+
+  const_view subview(std::size_t offset = 0, std::size_t count = npos) const {
+    return static_cast<const_view>(*this).subview(offset, count);
+  }
+
+  operator view() {
+    bitset::iterator first(_words.data(), 0);
+    return {first, first + std::ptrdiff_t(N)};
+  }
+
+  operator const_view() const {
+    bitset::const_iterator first(_words.data(), 0);
+    return {first, first + std::ptrdiff_t(N)};
+  }
+
+private:
+  static constexpr word_type tail_mask = (N % word_size == 0) ? ~word_type(0) : ~(~word_type(0) >> (N % word_size));
+
+  static constexpr word_type bit(std::size_t index) {
+    return word_type(1) << (word_size - 1 - index % word_size);
+  }
+
+  constexpr void clear_tail() {
+    if constexpr (word_count != 0) {
+      _words[word_count - 1] &= tail_mask;
+    }
+  }
+
+  constexpr std::size_t find_from(std::size_t pos) const {
+    std::size_t num = pos / word_size;
+    if (num >= word_count) {
+      return npos;
+    }
+    word_type word = _words[num] & (~word_type(0) >> (pos % word_size));
+    while (word == 0) {
+      if (++num == word_count) {
+        return npos;
+      }
+      word = _words[num];
+    }
+    return num * word_size + std::countl_zero(word);
+  }
+
+  std::array<word_type, word_count> _words{};
+};
+
+namespace bitset_detail {
+
+// A temporary static bitset mixed with another operand, unless that is a temporary bitset, whose own overloads
+// take the static bitset as a view.
+template <typename L, typename R>
+concept static_eager_operands =
+    bitset_operand<L> && bitset_operand<R> &&
+    ((!std::is_reference_v<L> && is_static_bitset<std::remove_const_t<L>>) ||
+     (!std::is_reference_v<R> && is_static_bitset<std::remove_const_t<R>>)) &&
+    !(is_static_bitset<std::remove_cvref_t<L>> && is_static_bitset<std::remove_cvref_t<R>>) &&
+    !std::is_same_v<std::remove_const_t<L>, bitset> && !std::is_same_v<std::remove_const_t<R>, bitset>;
+
+} // namespace bitset_detail
+
+// An expression would outlive a temporary static bitset, so these evaluate into a new bitset at once.
+template <typename L, typename R>
+  requires bitset_detail::static_eager_operands<L, R>
+bitset operator&(L&& lhs, R&& rhs) {
+  return bitset(bitset_detail::make_binary_expression<std::bit_and<>>(lhs, rhs));
+}
+
+template <typename L, typename R>
+  requires bitset_detail::static_eager_operands<L, R>
+bitset operator|(L&& lhs, R&& rhs) {
+  return bitset(bitset_detail::make_binary_expression<std::bit_or<>>(lhs, rhs));
+}
+
+template <typename L, typename R>
+  requires bitset_detail::static_eager_operands<L, R>
+bitset operator^(L&& lhs, R&& rhs) {
+  return bitset(bitset_detail::make_binary_expression<std::bit_xor<>>(lhs, rhs));
+}
+
+template <std::size_t N>
+std::string to_string(const static_bitset<N>& bs) {
+  return to_string(bitset::const_view(bs));
+}
+
+template <std::size_t N>
+std::ostream& operator<<(std::ostream& out, const static_bitset<N>& bs) {
+  return out << bitset::const_view(bs);
+}
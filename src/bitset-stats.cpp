@@ -0,0 +1,126 @@
+#include "bitset-stats.h"
+
+namespace bitset_stats {
+
+namespace {
+
+struct atomic_counters {
+  std::atomic<uint64_t> calls{0};
+  std::atomic<uint64_t> bits{0};
+  std::atomic<uint64_t> words{0};
+};
+
+std::array<atomic_counters, operation_count> operations;
+std::atomic<uint64_t> allocations{0};
+std::atomic<uint64_t> allocated_bytes{0};
+std::atomic<uint64_t> deallocations{0};
+std::atomic<uint64_t> aligned{0};
+std::atomic<uint64_t> misaligned{0};
+std::atomic<void*> trace_context{nullptr};
+
+void add(std::atomic<uint64_t>& counter, uint64_t value) {
+  counter.fetch_add(value, std::memory_order_relaxed);
+}
+
+uint64_t load(const std::atomic<uint64_t>& counter) {
+  return counter.load(std::memory_order_relaxed);
+}
+
+} // namespace
+
+std::string_view to_string(operation value) noexcept {
+  switch (value) {
+  case operation::construct:
+    return "construct";
+  case operation::copy:
+    return "copy";
+  case operation::and_assign:
+    return "and_assign";
+  case operation::or_assign:
+    return "or_assign";
+  case operation::xor_assign:
+    return "xor_assign";
+  case operation::flip:
+    return "flip";
+  case operation::set:
+    return "set";
+  case operation::reset:
+    return "reset";
+  case operation::count:
+    return "count";
+  case operation::all:
+    return "all";
+  case operation::any:
+    return "any";
+  case operation::equal:
+    return "equal";
+  case operation::find:
+    return "find";
+  case operation::to_string:
+    return "to_string";
+  }
+  return "unknown";
+}
+
+snapshot current() noexcept {
+  snapshot result;
+  for (std::size_t i = 0; i < operation_count; ++i) {
+    result.operations[i] = {load(operations[i].calls), load(operations[i].bits), load(operations[i].words)};
+  }
+  result.allocations = load(allocations);
+  result.allocated_bytes = load(allocated_bytes);
+  result.deallocations = load(deallocations);
+  result.aligned = load(aligned);
+  result.misaligned = load(misaligned);
+  return result;
+}
+
+void reset() noexcept {
+  for (atomic_counters& counters : operations) {
+    counters.calls.store(0, std::memory_order_relaxed);
+    counters.bits.store(0, std::memory_order_relaxed);
+    counters.words.store(0, std::memory_order_relaxed);
+  }
+  for (std::atomic<uint64_t>* counter : {&allocations, &allocated_bytes, &deallocations, &aligned, &misaligned}) {
+    counter->store(0, std::memory_order_relaxed);
+  }
+}
+
+void set_trace(trace_function function, void* context) noexcept {
+  trace_context.store(context, std::memory_order_relaxed);
+  detail::trace.store(function, std::memory_order_release);
+}
+
+namespace detail {
+
+std::atomic<trace_function> trace{nullptr};
+
+void record(operation op, std::size_t bits, std::size_t words) noexcept {
+  atomic_counters& counters = operations[std::size_t(op)];
+  add(counters.calls, 1);
+  add(counters.bits, bits);
+  add(counters.words, words);
+}
+
+void record_path(bool is_aligned) noexcept {
+  add(is_aligned ? aligned : misaligned, 1);
+}
+
+void record_allocation(std::size_t bytes) noexcept {
+  add(allocations, 1);
+  add(allocated_bytes, bytes);
+}
+
+void record_deallocation() noexcept {
+  add(deallocations, 1);
+}
+
+void end_span(const span_event& event) noexcept {
+  if (trace_function function = trace.load(std::memory_order_acquire)) {
+    function(event, trace_context.load(std::memory_order_relaxed));
+  }
+}
+
+} // namespace detail
+
+} // namespace bitset_stats
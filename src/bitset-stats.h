@@ -0,0 +1,139 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+// Opt-in instrumentation of the hot paths. Compile everything with `-DBITSET_STATS=1` to count calls, bits and
+// words per operation, heap allocations of `bitset`, and aligned and misaligned passes of two-view operations.
+// Without it the hooks expand to nothing and `current()` returns zeros.
+//
+// Counters are relaxed atomics, so they can be read while other threads work. Operations that are built on
+// other ones count both, e.g. a copy also counts the `|=` that fills it.
+#ifndef BITSET_STATS
+#define BITSET_STATS 0
+#endif
+
+namespace bitset_stats {
+
+inline constexpr bool enabled = BITSET_STATS != 0;
+
+enum class operation : std::size_t {
+  construct,
+  copy,
+  and_assign,
+  or_assign,
+  xor_assign,
+  flip,
+  set,
+  reset,
+  count,
+  all,
+  any,
+  equal,
+  find,
+  to_string,
+};
+
+inline constexpr std::size_t operation_count = std::size_t(operation::to_string) + 1;
+
+std::string_view to_string(operation value) noexcept;
+
+struct counters {
+  uint64_t calls = 0;
+  uint64_t bits = 0;
+  // Words of the operand's own word type that the bits span, so a misaligned view counts every word it touches.
+  uint64_t words = 0;
+};
+
+struct snapshot {
+  std::array<counters, operation_count> operations{};
+  uint64_t allocations = 0;
+  uint64_t allocated_bytes = 0;
+  uint64_t deallocations = 0;
+  uint64_t aligned = 0;
+  uint64_t misaligned = 0;
+
+  const counters& operator[](operation value) const {
+    return operations[std::size_t(value)];
+  }
+};
+
+snapshot current() noexcept;
+void reset() noexcept;
+
+struct span_event {
+  operation op;
+  std::size_t bits;
+  std::chrono::steady_clock::time_point start;
+  std::chrono::nanoseconds duration;
+};
+
+// Called when every instrumented operation ends, from the thread that ran it. Set it before the operations of
+// interest start; nullptr turns tracing off.
+using trace_function = void (*)(const span_event& event, void* context);
+void set_trace(trace_function function, void* context = nullptr) noexcept;
+
+namespace detail {
+
+extern std::atomic<trace_function> trace;
+
+void record(operation op, std::size_t bits, std::size_t words) noexcept;
+void record_path(bool aligned) noexcept;
+void record_allocation(std::size_t bytes) noexcept;
+void record_deallocation() noexcept;
+void end_span(const span_event& event) noexcept;
+
+// Counts an operation and, while tracing is on, reports its duration when the scope ends.
+class span {
+public:
+  span(operation op, std::size_t bits, std::size_t words) noexcept
+      : _op(op)
+      , _bits(bits)
+      , _traced(trace.load(std::memory_order_acquire) != nullptr) {
+    record(op, bits, words);
+    if (_traced) {
+      _start = std::chrono::steady_clock::now();
+    }
+  }
+
+  span(const span&) = delete;
+  span& operator=(const span&) = delete;
+
+  ~span() {
+    if (_traced) {
+      end_span({_op, _bits, _start, std::chrono::steady_clock::now() - _start});
+    }
+  }
+
+private:
+  operation _op;
+  std::size_t _bits;
+  bool _traced;
+  std::chrono::steady_clock::time_point _start;
+};
+
+} // namespace detail
+
+// Number of `word_size`-bit words spanned by `bits` bits that start `offset` bits into a word.
+constexpr std::size_t word_span(std::size_t offset, std::size_t bits, std::size_t word_size) noexcept {
+  return (bits == 0) ? 0 : (offset % word_size + bits - 1) / word_size + 1;
+}
+
+} // namespace bitset_stats
+
+#if BITSET_STATS
+#define BITSET_STATS_SPAN(op, bits, words)                                                                             \
+  ::bitset_stats::detail::span bitset_stats_span(::bitset_stats::operation::op, bits, words)
+#define BITSET_STATS_PATH(aligned) ::bitset_stats::detail::record_path(aligned)
+#define BITSET_STATS_ALLOCATION(bytes) ::bitset_stats::detail::record_allocation(bytes)
+#define BITSET_STATS_DEALLOCATION() ::bitset_stats::detail::record_deallocation()
+#else
+#define BITSET_STATS_SPAN(op, bits, words) static_cast<void>(0)
+#define BITSET_STATS_PATH(aligned) static_cast<void>(0)
+#define BITSET_STATS_ALLOCATION(bytes) static_cast<void>(0)
+#define BITSET_STATS_DEALLOCATION() static_cast<void>(0)
+#endif
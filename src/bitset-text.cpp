@@ -0,0 +1,135 @@
+#include "bitset-text.h"
+#include "bitset.h"
+
+#include <array>
+#include <string>
+
+namespace {
+
+constexpr std::string_view hex_digits = "0123456789abcdef";
+constexpr std::string_view base64_digits = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+// Digit values, with `invalid` set for other characters so that a whole string is checked with one test.
+constexpr uint8_t invalid = 0x80;
+
+constexpr std::array<uint8_t, 256> make_values(std::string_view digits) {
+  std::array<uint8_t, 256> values;
+  values.fill(invalid);
+  for (std::size_t i = 0; i < digits.size(); ++i) {
+    values[uint8_t(digits[i])] = uint8_t(i);
+  }
+  return values;
+}
+
+constexpr std::array<uint8_t, 256> make_hex_values() {
+  std::array<uint8_t, 256> values = make_values(hex_digits);
+  for (std::size_t i = 10; i < 16; ++i) {
+    values[uint8_t('A' + i - 10)] = uint8_t(i);
+  }
+  return values;
+}
+
+constexpr std::array<uint8_t, 256> hex_values = make_hex_values();
+constexpr std::array<uint8_t, 256> base64_values = make_values(base64_digits);
+
+uint8_t value(const std::array<uint8_t, 256>& values, char c) {
+  return values[uint8_t(c)];
+}
+
+// The bits of `str`, `bits_per_char` per character, trimmed to `size`.
+std::optional<bitset> decode(
+    std::string_view str, std::size_t bits_per_char, const std::array<uint8_t, 256>& values, std::size_t size,
+    const bitset::allocator_type& alloc
+) {
+  std::size_t chars_per_word = bitset::word_size / bits_per_char;
+  bitset result(alloc);
+  result.reserve(size);
+  uint8_t flags = 0;
+  for (std::size_t i = 0; i < str.size(); i += chars_per_word) {
+    std::size_t chars = std::min(chars_per_word, str.size() - i);
+    bitset::word_type word = 0;
+    for (std::size_t j = 0; j < chars; ++j) {
+      uint8_t digit = value(values, str[i + j]);
+      flags |= digit;
+      word = (word << bits_per_char) | digit;
+    }
+    std::size_t bits = std::min(chars * bits_per_char, size - result.size());
+    result.append_word(word >> (chars * bits_per_char - bits), bits);
+  }
+  if ((flags & invalid) != 0) {
+    return std::nullopt;
+  }
+  return result;
+}
+
+} // namespace
+
+std::optional<bitset> from_string(std::string_view str, const bitset::allocator_type& alloc) {
+  if (!bitset_text::is_binary(str.data(), str.size())) {
+    return std::nullopt;
+  }
+  return bitset(str, alloc);
+}
+
+std::string to_hex(const bitset::const_view& bs) {
+  std::string out((bs.size() + 3) / 4, '0');
+  std::size_t pos = 0;
+  bitset_detail::as_expression(bs).for_each_word([&out, &pos](uint64_t word, std::size_t count) {
+    for (std::size_t bit = 0; bit < count; bit += 4) {
+      out[pos++] = hex_digits[(word >> (60 - bit)) & 0xf];
+    }
+    return true;
+  });
+  return out;
+}
+
+std::optional<bitset> from_hex(std::string_view str, std::size_t size, const bitset::allocator_type& alloc) {
+  if (size == bitset::npos) {
+    size = str.size() * 4;
+  }
+  if ((size + 3) / 4 != str.size()) {
+    return std::nullopt;
+  }
+  return decode(str, 4, hex_values, size, alloc);
+}
+
+std::string to_base64(const bitset::const_view& bs) {
+  std::string bytes((bs.size() + 7) / 8, '\0');
+  std::size_t length = 0;
+  bitset_detail::as_expression(bs).for_each_word([&bytes, &length](uint64_t word, std::size_t count) {
+    for (std::size_t bit = 0; bit < count; bit += 8) {
+      bytes[length++] = char(word >> (56 - bit));
+    }
+    return true;
+  });
+
+  auto byte = [&bytes](std::size_t i) { return (i < bytes.size()) ? uint32_t(uint8_t(bytes[i])) : 0; };
+  std::string out((bytes.size() + 2) / 3 * 4, '=');
+  for (std::size_t i = 0, pos = 0; i < bytes.size(); i += 3) {
+    uint32_t group = (byte(i) << 16) | (byte(i + 1) << 8) | byte(i + 2);
+    std::size_t chars = std::min<std::size_t>(4, (bytes.size() - i) * 8 / 6 + 1);
+    for (std::size_t j = 0; j < chars; ++j) {
+      out[pos + j] = base64_digits[(group >> (18 - 6 * j)) & 0x3f];
+    }
+    pos += 4;
+  }
+  return out;
+}
+
+std::optional<bitset> from_base64(std::string_view str, std::size_t size, const bitset::allocator_type& alloc) {
+  if (str.size() % 4 != 0) {
+    return std::nullopt;
+  }
+  std::size_t padding = 0;
+  while (padding < 2 && padding < str.size() && str[str.size() - 1 - padding] == '=') {
+    ++padding;
+  }
+  std::size_t bytes = str.size() / 4 * 3 - padding;
+  if (size == bitset::npos) {
+    size = bytes * 8;
+  }
+  if ((size + 7) / 8 != bytes) {
+    return std::nullopt;
+  }
+  return decode(str.substr(0, str.size() - padding), 6, base64_values, size, alloc);
+}
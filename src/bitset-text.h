@@ -0,0 +1,111 @@
+#pragma once
+
+#include "bitset-word.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+// Conversions between words and '0'/'1' characters, eight characters per 64-bit operation.
+namespace bitset_text {
+
+using word_type = uint64_t;
+
+inline constexpr word_type ones = 0x0101010101010101;
+inline constexpr word_type zeros = 0x3030303030303030;
+
+inline word_type load(const char* in) {
+  word_type chars;
+  std::memcpy(&chars, in, sizeof(chars));
+  if constexpr (std::endian::native == std::endian::big) {
+    chars = __builtin_bswap64(chars);
+  }
+  return chars;
+}
+
+inline void store(char* out, word_type chars) {
+  if constexpr (std::endian::native == std::endian::big) {
+    chars = __builtin_bswap64(chars);
+  }
+  std::memcpy(out, &chars, sizeof(chars));
+}
+
+// Eight bits from the characters, the first one in the most significant bit. Only '1' reads as 1.
+inline unsigned parse_byte(word_type chars) {
+  word_type diff = chars ^ (zeros | ones);
+  word_type nonzero = ((diff & 0x7f7f7f7f7f7f7f7f) + 0x7f7f7f7f7f7f7f7f) | diff;
+  word_type bits = (~nonzero >> 7) & ones;
+  return unsigned((bits * 0x8040201008040201) >> 56);
+}
+
+// Characters for a byte, its most significant bit first.
+inline word_type format_byte(unsigned byte) {
+  word_type spread = (word_type(byte) * ones) & 0x0102040810204080;
+  return (((spread + 0x7f7f7f7f7f7f7f7f) >> 7) & ones) | zeros;
+}
+
+// The `count` high bits of a word read from `count` characters.
+inline word_type parse_word(const char* in, std::size_t count) {
+  word_type word = 0;
+  std::size_t i = 0;
+  for (; i + 8 <= count; i += 8) {
+    word |= word_type(parse_byte(load(in + i))) << (56 - i);
+  }
+  for (; i < count; ++i) {
+    word |= word_type(in[i] == '1') << (63 - i);
+  }
+  return word;
+}
+
+inline void format_word(word_type word, std::size_t count, char* out) {
+  std::size_t i = 0;
+  for (; i + 8 <= count; i += 8) {
+    store(out + i, format_byte(unsigned(word >> (56 - i)) & 0xff));
+  }
+  for (; i < count; ++i) {
+    out[i] = char('0' + ((word >> (63 - i)) & 1));
+  }
+}
+
+// Words of other widths go through the 64-bit functions above in pieces.
+template <typename W>
+W parse_word(const char* in, std::size_t count) {
+  constexpr std::size_t bits = bitset_word::bits<W>;
+  if constexpr (bits <= 64) {
+    return W(parse_word(in, count) >> (64 - bits));
+  } else {
+    W word = 0;
+    for (std::size_t i = 0; i < count; i += 64) {
+      word |= W(parse_word(in + i, std::min<std::size_t>(64, count - i))) << (bits - 64 - i);
+    }
+    return word;
+  }
+}
+
+template <typename W>
+void format_word(W word, std::size_t count, char* out) {
+  constexpr std::size_t bits = bitset_word::bits<W>;
+  if constexpr (bits <= 64) {
+    format_word(word_type(word) << (64 - bits), count, out);
+  } else {
+    for (std::size_t i = 0; i < count; i += 64) {
+      format_word(word_type(word >> (bits - 64 - i)), std::min<std::size_t>(64, count - i), out + i);
+    }
+  }
+}
+
+inline bool is_binary(const char* in, std::size_t count) {
+  word_type invalid = 0;
+  std::size_t i = 0;
+  for (; i + 8 <= count; i += 8) {
+    invalid |= (load(in + i) & ~ones) ^ zeros;
+  }
+  for (; i < count; ++i) {
+    invalid |= word_type(in[i] != '0' && in[i] != '1');
+  }
+  return invalid == 0;
+}
+
+} // namespace bitset_text
@@ -2,19 +2,29 @@
 
 #include "bitset-iterator.h"
 #include "bitset-reference.h"
+#include "bitset-dispatch.h"
+#include "bitset-expression.h"
+#include "bitset-ones.h"
+#include "bitset-stats.h"
+#include "bitset-text.h"
+#include "bitset-word.h"
 #include "bitset.h"
 
 #include <algorithm>
 #include <bit>
+#include <concepts>
 #include <cstddef>
 #include <cstdint>
 #include <cstring>
+#include <functional>
+#include <ostream>
 #include <string>
+#include <type_traits>
 
 template <typename U>
 class bitset_view {
 public:
-  using word_type = uint64_t;
+  using word_type = std::remove_const_t<U>;
   using value_type = bool;
   using reference = bitset_reference<U>;
   using pointer = U*;
@@ -24,12 +34,19 @@ public:
   using view = bitset_view<U>;
   using const_view = bitset_view<const U>;
 
-  static constexpr std::size_t word_size = 64;
+  static constexpr std::size_t word_size = bitset_word::bits<word_type>;
   static constexpr std::size_t npos = -1;
 
 private:
-  friend class bitset;
+  template <typename W>
+  friend class basic_bitset;
   friend bitset_view<std::remove_const<U>>;
+  template <typename View>
+  friend class bitset_view_expression;
+  template <typename T>
+  friend std::string to_string(const bitset_view<T>& bs);
+  template <typename T>
+  friend std::ostream& operator<<(std::ostream& out, const bitset_view<T>& bs);
   iterator left;
   iterator right;
 
@@ -37,10 +54,17 @@ private:
     return (~word_type(0) >> begin) & (~word_type(0) << (word_size - end));
   }
 
+  using binary_kernel = void (*)(word_type*, const word_type*, std::size_t, std::size_t);
+  using unary_kernel = void (*)(word_type*, std::size_t);
+
   template <typename Function>
-  void bit_operator(const const_view& other, Function operation) const {
+  void bit_operator(const const_view& other, Function operation, binary_kernel kernel) const {
+    if (empty()) {
+      return;
+    }
     auto this_iter = begin();
     auto other_iter = other.begin();
+    BITSET_STATS_PATH(this_iter._index == other_iter._index);
 
     pointer current_word;
     word_type other_word;
@@ -48,21 +72,24 @@ private:
     if (this_iter._index != 0) {
       current_word = this_iter._word;
       word_type mask = get_mask(this_iter._index, (this_iter._word == end()._word) ? end()._index : word_size);
-      other_word = other_iter.word(std::min(word_size - this_iter._index, std::size_t(end() - this_iter)));
-      word_type new_word = (mask & operation(*current_word, other_word >> this_iter._index));
+      other_word = (other_iter._index == this_iter._index)
+                       ? *other_iter._word
+                       : other_iter.word(std::min(word_size - this_iter._index, std::size_t(end() - this_iter))) >>
+                             this_iter._index;
+      word_type new_word = (mask & operation(*current_word, other_word));
       *current_word = (new_word | (~mask & *current_word));
 
       other_iter += word_size - this_iter._index;
       this_iter += word_size - this_iter._index;
     }
 
-    while (this_iter < end() && this_iter + word_size <= end()) {
-      current_word = this_iter._word;
-      other_word = other_iter.word(word_size);
-      *current_word = operation(*current_word, other_word);
-
-      this_iter += word_size;
-      other_iter += word_size;
+    if (this_iter < end()) {
+      std::size_t words = std::size_t(end() - this_iter) / word_size;
+      if (words != 0) {
+        kernel(this_iter._word, other_iter._word, words, other_iter._index);
+      }
+      this_iter += words * word_size;
+      other_iter += words * word_size;
     }
 
     if (this_iter < end()) {
@@ -74,8 +101,82 @@ private:
     }
   }
 
+  using pair_count_kernel = std::size_t (*)(const word_type*, const word_type*, std::size_t, std::size_t);
+  using pair_any_kernel = bool (*)(const word_type*, const word_type*, std::size_t, std::size_t);
+
+  // Walks this view and the first `size()` bits of `other` the way `bit_operator` does, without writing:
+  // `edge(a, b)` gets the partial first and last words, masked, and `body` the whole words in between. Either
+  // one ends the walk by returning true.
+  template <typename Edge, typename Body>
+  void pair_operator(const const_view& other, Edge edge, Body body) const {
+    if (empty()) {
+      return;
+    }
+    auto this_iter = begin();
+    auto other_iter = other.begin();
+    BITSET_STATS_PATH(this_iter._index == other_iter._index);
+
+    if (this_iter._index != 0) {
+      word_type mask = get_mask(this_iter._index, (this_iter._word == end()._word) ? end()._index : word_size);
+      word_type other_word =
+          (other_iter._index == this_iter._index)
+              ? *other_iter._word
+              : other_iter.word(std::min(word_size - this_iter._index, std::size_t(end() - this_iter))) >>
+                    this_iter._index;
+      if (edge(*this_iter._word & mask, other_word & mask)) {
+        return;
+      }
+      other_iter += word_size - this_iter._index;
+      this_iter += word_size - this_iter._index;
+    }
+
+    if (this_iter < end()) {
+      std::size_t words = std::size_t(end() - this_iter) / word_size;
+      if (words != 0 && body(this_iter._word, other_iter._word, words, other_iter._index)) {
+        return;
+      }
+      this_iter += words * word_size;
+      other_iter += words * word_size;
+    }
+
+    if (this_iter < end()) {
+      word_type mask = get_mask(0, end()._index);
+      edge(*this_iter._word & mask, other_iter.word(end()._index) & mask);
+    }
+  }
+
+  template <typename Function>
+  std::size_t count_operator(const const_view& other, Function operation, pair_count_kernel kernel) const {
+    std::size_t ans = 0;
+    pair_operator(
+        other,
+        [&](word_type a, word_type b) {
+          ans += bitset_word::popcount(word_type(operation(a, b)));
+          return false;
+        },
+        [&](const word_type* lhs, const word_type* rhs, std::size_t words, std::size_t shift) {
+          ans += kernel(lhs, rhs, words, shift);
+          return false;
+        }
+    );
+    return ans;
+  }
+
   template <typename Function>
-  void unary_operator(Function operation) const {
+  bool any_operator(const const_view& other, Function operation, pair_any_kernel kernel) const {
+    bool found = false;
+    pair_operator(
+        other,
+        [&](word_type a, word_type b) { return found = (operation(a, b) != 0); },
+        [&](const word_type* lhs, const word_type* rhs, std::size_t words, std::size_t shift) {
+          return found = kernel(lhs, rhs, words, shift);
+        }
+    );
+    return found;
+  }
+
+  template <typename Function>
+  void unary_operator(Function operation, unary_kernel kernel) const {
     auto this_iter = begin();
     pointer current_word;
 
@@ -88,10 +189,12 @@ private:
       this_iter += word_size - this_iter._index;
     }
 
-    while (this_iter < end() && this_iter + word_size <= end()) {
-      current_word = this_iter._word;
-      *current_word = operation(*current_word);
-      this_iter += word_size;
+    if (this_iter < end()) {
+      std::size_t words = std::size_t(end() - this_iter) / word_size;
+      if (words != 0) {
+        kernel(this_iter._word, words);
+      }
+      this_iter += words * word_size;
     }
 
     if (this_iter < end()) {
@@ -103,7 +206,111 @@ private:
   }
 
   word_type get_word(size_t num, size_t size) const {
-    return (left + num * word_size).word(size);
+    return iterator(left._word + num, left._index).word(size);
+  }
+
+  // Stores the `size` high bits of `value` as the bits that `get_word(num, size)` reads.
+  void put_word(size_t num, size_t size, word_type value) const {
+    pointer word = left._word + num;
+    word_type mask = ~word_type(0) << (word_size - size);
+    *word = (*word & ~(mask >> left._index)) | ((value & mask) >> left._index);
+    if (left._index != 0 && size > word_size - left._index) {
+      std::size_t back = word_size - left._index;
+      word[1] = (word[1] & ~(mask << back)) | ((value & mask) << back);
+    }
+  }
+
+  // Whether a word holding a bit of the view is in [first, last). Unrelated buffers are ordered by `std::less`.
+  bool overlaps(const word_type* first, const word_type* last) const {
+    if (empty()) {
+      return false;
+    }
+    return std::less<>()(left._word, last) && std::less<>()(first, words_end());
+  }
+
+  // Words the view touches, as counted by the stats hooks.
+  std::size_t word_span() const {
+    return bitset_stats::word_span(left._index, size(), word_size);
+  }
+
+  const word_type* words_end() const {
+    return right._word + ((right._index != 0) ? 1 : 0);
+  }
+
+  template <typename E, typename Function>
+  void expression_operator(const E& other, Function operation) const {
+    for (std::size_t num = 0; num * word_size < size(); ++num) {
+      std::size_t count = std::min(word_size, size() - num * word_size);
+      put_word(num, count, operation(get_word(num, count), other.get_word(num, count)));
+    }
+  }
+
+  std::size_t position(const U* word, std::size_t bit) const {
+    return std::size_t(word - left._word) * word_size + bit - left._index;
+  }
+
+  // First bit equal to `value` in [from, size()).
+  std::size_t find_forward(std::size_t from, bool value) const {
+    BITSET_STATS_SPAN(find, size() - std::min(from, size()), subview(std::min(from, size())).word_span());
+    if (from >= size()) {
+      return npos;
+    }
+    iterator first = begin() + from;
+    iterator last = end();
+    word_type invert = value ? 0 : ~word_type(0);
+
+    word_type word = (*first._word ^ invert) & (~word_type(0) >> first._index);
+    if (first._word == last._word) {
+      word &= get_mask(0, last._index);
+    }
+    if (word != 0 || first._word == last._word) {
+      return (word != 0) ? position(first._word, bitset_word::countl_zero(word)) : npos;
+    }
+
+    pointer current = first._word + 1;
+    std::size_t words = last._word - current;
+    std::size_t found = (words != 0) ? bitset_word::kernels<word_type>().find_words(current, words, invert) : 0;
+    if (found < words) {
+      return position(current + found, bitset_word::countl_zero(current[found] ^ invert));
+    }
+
+    if (last._index != 0) {
+      word = (*last._word ^ invert) & get_mask(0, last._index);
+      if (word != 0) {
+        return position(last._word, bitset_word::countl_zero(word));
+      }
+    }
+    return npos;
+  }
+
+  // Last bit equal to `value` in [0, to).
+  std::size_t find_backward(std::size_t to, bool value) const {
+    to = std::min(to, size());
+    BITSET_STATS_SPAN(find, to, subview(0, to).word_span());
+    if (to == 0) {
+      return npos;
+    }
+    iterator first = begin();
+    iterator back = begin() + (to - 1);
+    word_type invert = value ? 0 : ~word_type(0);
+
+    word_type word = (*back._word ^ invert) & (~word_type(0) << (word_size - 1 - back._index));
+    if (back._word == first._word) {
+      word &= ~word_type(0) >> first._index;
+    }
+    if (word != 0 || back._word == first._word) {
+      return (word != 0) ? position(back._word, word_size - 1 - bitset_word::countr_zero(word)) : npos;
+    }
+
+    pointer current = first._word + 1;
+    std::size_t words = back._word - current;
+    std::size_t found = (words != 0) ? bitset_word::kernels<word_type>().find_last_words(current, words, invert) : 0;
+    if (found < words) {
+      return position(current + found, word_size - 1 - bitset_word::countr_zero(current[found] ^ invert));
+    }
+
+    word = (*first._word ^ invert) & (~word_type(0) >> first._index);
+    return (word != 0) ? position(first._word, word_size - 1 - bitset_word::countr_zero(word)) : npos;
   }
 
   template <typename V>
@@ -117,22 +324,31 @@ private:
     return {begin() + offset, begin() + size()};
   }
 
-  bool pattern_matching(std::size_t pattern) const {
-    iterator iter = begin();
-    while (iter < end()) {
-      std::size_t count = len(iter);
-      if (iter.word(count) != (pattern & get_mask(0, count))) {
-        return false;
-      }
-      iter += count;
+  bool pattern_matching(word_type pattern) const {
+    iterator first = begin();
+    iterator last = end();
+    if (first == last) {
+      return true;
+    }
+    if (first._word == last._word) {
+      word_type mask = get_mask(first._index, last._index);
+      return (*first._word & mask) == (pattern & mask);
+    }
+    word_type mask = get_mask(first._index, word_size);
+    if ((*first._word & mask) != (pattern & mask)) {
+      return false;
+    }
+    std::size_t words = last._word - first._word - 1;
+    if (words != 0 && !bitset_word::kernels<word_type>().match_words(first._word + 1, words, pattern)) {
+      return false;
+    }
+    if (last._index != 0) {
+      mask = get_mask(0, last._index);
+      return (*last._word & mask) == (pattern & mask);
     }
     return true;
   }
 
-  std::size_t len(const iterator& iter) const {
-    return std::min(word_size, std::size_t(end() - iter));
-  }
-
 public:
   bitset_view() = default;
   bitset_view(const bitset_view&) = default;
@@ -164,60 +380,199 @@ public:
   }
 
   bitset_view<U> operator&=(const const_view& other) const {
-    bit_operator(other, [](word_type a, word_type b) { return a & b; });
+    BITSET_STATS_SPAN(and_assign, size(), word_span());
+    bit_operator(other, [](word_type a, word_type b) { return a & b; }, bitset_word::kernels<word_type>().and_words);
     return *this;
   }
 
   bitset_view<U> operator|=(const const_view& other) const {
-    bit_operator(other, [](word_type a, word_type b) { return a | b; });
+    BITSET_STATS_SPAN(or_assign, size(), word_span());
+    bit_operator(other, [](word_type a, word_type b) { return a | b; }, bitset_word::kernels<word_type>().or_words);
     return *this;
   }
 
   bitset_view<U> operator^=(const const_view& other) const {
-    bit_operator(other, [](word_type a, word_type b) { return a ^ b; });
+    BITSET_STATS_SPAN(xor_assign, size(), word_span());
+    bit_operator(other, [](word_type a, word_type b) { return a ^ b; }, bitset_word::kernels<word_type>().xor_words);
+    return *this;
+  }
+
+  // An expression is evaluated straight into the view. Only when one of its operands shares words with the view,
+  // at any offset, is it evaluated into a bitset first.
+  template <bitset_expression_type E>
+  bitset_view<U> operator&=(const E& other) const {
+    if (other.overlaps(left._word, words_end())) {
+      return *this &= basic_bitset<word_type>(other);
+    }
+    BITSET_STATS_SPAN(and_assign, size(), word_span());
+    expression_operator(other, std::bit_and<>());
+    return *this;
+  }
+
+  template <bitset_expression_type E>
+  bitset_view<U> operator|=(const E& other) const {
+    if (other.overlaps(left._word, words_end())) {
+      return *this |= basic_bitset<word_type>(other);
+    }
+    BITSET_STATS_SPAN(or_assign, size(), word_span());
+    expression_operator(other, std::bit_or<>());
+    return *this;
+  }
+
+  template <bitset_expression_type E>
+  bitset_view<U> operator^=(const E& other) const {
+    if (other.overlaps(left._word, words_end())) {
+      return *this ^= basic_bitset<word_type>(other);
+    }
+    BITSET_STATS_SPAN(xor_assign, size(), word_span());
+    expression_operator(other, std::bit_xor<>());
     return *this;
   }
 
   bitset_view<U> flip() const {
-    unary_operator([](word_type b) { return ~b; });
+    BITSET_STATS_SPAN(flip, size(), word_span());
+    unary_operator([](word_type b) { return ~b; }, bitset_word::kernels<word_type>().flip_words);
     return *this;
   }
 
   bitset_view<U> set() const {
-    unary_operator([](word_type /*b*/) { return ~word_type(0); });
+    BITSET_STATS_SPAN(set, size(), word_span());
+    unary_operator([](word_type /*b*/) { return ~word_type(0); }, bitset_word::kernels<word_type>().set_words);
     return *this;
   }
 
   bitset_view<U> reset() const {
-    unary_operator([](word_type /*b*/) { return 0; });
+    BITSET_STATS_SPAN(reset, size(), word_span());
+    unary_operator([](word_type /*b*/) { return word_type(0); }, bitset_word::kernels<word_type>().reset_words);
     return *this;
   }
 
   bool all() const {
+    BITSET_STATS_SPAN(all, size(), word_span());
     return pattern_matching(~word_type(0));
   }
 
   bool any() const {
+    BITSET_STATS_SPAN(any, size(), word_span());
     return !pattern_matching(0);
   }
 
   std::size_t count() const {
-    std::size_t ans = 0;
-    iterator iter = begin();
-    while (iter < end()) {
-      std::size_t count = len(iter);
-      ans += std::popcount(iter.word(count));
-      iter += count;
+    BITSET_STATS_SPAN(count, size(), word_span());
+    iterator first = begin();
+    iterator last = end();
+    if (first._word == last._word) {
+      return (first._index == last._index)
+                 ? 0
+                 : bitset_word::popcount(*first._word & get_mask(first._index, last._index));
+    }
+    std::size_t ans = bitset_word::popcount(*first._word & get_mask(first._index, word_size));
+    std::size_t words = last._word - first._word - 1;
+    if (words != 0) {
+      ans += bitset_word::kernels<word_type>().count_words(first._word + 1, words);
+    }
+    if (last._index != 0) {
+      ans += bitset_word::popcount(*last._word & get_mask(0, last._index));
     }
     return ans;
   }
 
+  // Ones in `*this op other` for the first `size()` bits of `other`, computed in one pass without evaluating
+  // the operation into words. `xor_count` is the Hamming distance.
+  std::size_t and_count(const const_view& other) const {
+    BITSET_STATS_SPAN(count, size(), word_span());
+    return count_operator(
+        other, [](word_type a, word_type b) { return a & b; }, bitset_word::kernels<word_type>().and_count_words
+    );
+  }
+
+  std::size_t or_count(const const_view& other) const {
+    BITSET_STATS_SPAN(count, size(), word_span());
+    return count_operator(
+        other, [](word_type a, word_type b) { return a | b; }, bitset_word::kernels<word_type>().or_count_words
+    );
+  }
+
+  std::size_t xor_count(const const_view& other) const {
+    BITSET_STATS_SPAN(count, size(), word_span());
+    return count_operator(
+        other, [](word_type a, word_type b) { return a ^ b; }, bitset_word::kernels<word_type>().xor_count_words
+    );
+  }
+
+  std::size_t andnot_count(const const_view& other) const {
+    BITSET_STATS_SPAN(count, size(), word_span());
+    return count_operator(
+        other, [](word_type a, word_type b) { return a & ~b; }, bitset_word::kernels<word_type>().andnot_count_words
+    );
+  }
+
+  bool intersects(const const_view& other) const {
+    BITSET_STATS_SPAN(any, size(), word_span());
+    return any_operator(
+        other, [](word_type a, word_type b) { return a & b; }, bitset_word::kernels<word_type>().and_any_words
+    );
+  }
+
+  // Whether every one of this view is also set in `other`.
+  bool is_subset_of(const const_view& other) const {
+    BITSET_STATS_SPAN(any, size(), word_span());
+    return !any_operator(
+        other, [](word_type a, word_type b) { return a & ~b; }, bitset_word::kernels<word_type>().andnot_any_words
+    );
+  }
+
+  bitset_ones ones() const
+    requires std::same_as<word_type, uint64_t>
+  {
+    return {left._word, left._index, size()};
+  }
+
+  // Searches return the index of the matching bit within the view, or `npos`. `find_next` and `find_prev`
+  // look strictly after and strictly before `pos`.
+  std::size_t find_first() const {
+    return find_forward(0, true);
+  }
+
+  std::size_t find_next(std::size_t pos) const {
+    return (pos < size()) ? find_forward(pos + 1, true) : npos;
+  }
+
+  std::size_t find_last() const {
+    return find_backward(size(), true);
+  }
+
+  std::size_t find_prev(std::size_t pos) const {
+    return find_backward(pos, true);
+  }
+
+  std::size_t find_first_zero() const {
+    return find_forward(0, false);
+  }
+
+  std::size_t find_next_zero(std::size_t pos) const {
+    return (pos < size()) ? find_forward(pos + 1, false) : npos;
+  }
+
+  std::size_t find_last_zero() const {
+    return find_backward(size(), false);
+  }
+
+  std::size_t find_prev_zero(std::size_t pos) const {
+    return find_backward(pos, false);
+  }
+
   friend bool operator==(const bitset_view& left, const bitset_view& right) {
     if (left.size() != right.size()) {
       return false;
     }
+    BITSET_STATS_SPAN(equal, left.size(), bitset_stats::word_span(left.begin().bit_offset(), left.size(), word_size));
+    if (left.empty()) {
+      return true;
+    }
     auto this_iter = left.begin();
     auto other_iter = right.begin();
+    BITSET_STATS_PATH(this_iter._index == other_iter._index);
 
     pointer current_word;
     word_type other_word;
@@ -226,23 +581,26 @@ public:
       current_word = this_iter._word;
       word_type mask =
           get_mask(this_iter._index, (this_iter._word == left.end()._word) ? left.end()._index : word_size);
-      other_word = other_iter.word(std::min(word_size - this_iter._index, std::size_t(left.end() - this_iter)));
-      if ((*current_word & mask) != (mask & (other_word >> this_iter._index))) {
+      other_word =
+          (other_iter._index == this_iter._index)
+              ? *other_iter._word
+              : other_iter.word(std::min(word_size - this_iter._index, std::size_t(left.end() - this_iter))) >>
+                    this_iter._index;
+      if ((*current_word & mask) != (mask & other_word)) {
         return false;
       }
       other_iter += word_size - this_iter._index;
       this_iter += word_size - this_iter._index;
     }
 
-    while (this_iter < left.end() && this_iter + word_size <= left.end()) {
-      current_word = this_iter._word;
-      other_word = other_iter.word(word_size);
-      if (*current_word != other_word) {
+    if (this_iter < left.end()) {
+      std::size_t words = std::size_t(left.end() - this_iter) / word_size;
+      if (words != 0 &&
+          !bitset_word::kernels<word_type>().equal_words(this_iter._word, other_iter._word, words, other_iter._index)) {
         return false;
       }
-
-      this_iter += word_size;
-      other_iter += word_size;
+      this_iter += words * word_size;
+      other_iter += words * word_size;
     }
 
     if (this_iter < left.end()) {
@@ -276,17 +634,36 @@ public:
 
 template <typename T>
 std::string to_string(const bitset_view<T>& bs) {
-  std::string out;
-  for (std::size_t i = 0; i < bs.size(); ++i) {
-    out += (bs[i]) ? '1' : '0';
+  constexpr std::size_t word_size = bitset_view<T>::word_size;
+  BITSET_STATS_SPAN(to_string, bs.size(), bitset_stats::word_span(bs.begin().bit_offset(), bs.size(), word_size));
+  std::string out(bs.size(), '0');
+  for (std::size_t pos = 0; pos < bs.size(); pos += word_size) {
+    std::size_t count = std::min(word_size, bs.size() - pos);
+    bitset_text::format_word(bs.get_word(pos / word_size, count), count, out.data() + pos);
   }
   return out;
 }
 
 template <typename T>
 std::ostream& operator<<(std::ostream& out, const bitset_view<T>& bs) {
-  for (std::size_t i = 0; i < bs.size(); ++i) {
-    out << bs[i];
+  constexpr std::size_t word_size = bitset_view<T>::word_size;
+  constexpr std::size_t buffer_size = 4096;
+  char buffer[buffer_size];
+  std::size_t used = 0;
+  for (std::size_t pos = 0; pos < bs.size(); pos += word_size) {
+    std::size_t count = std::min(word_size, bs.size() - pos);
+    if (used + count > buffer_size) {
+      out.write(buffer, std::streamsize(used));
+      used = 0;
+    }
+    bitset_text::format_word(bs.get_word(pos / word_size, count), count, buffer + used);
+    used += count;
   }
+  out.write(buffer, std::streamsize(used));
   return out;
 }
+
+template <typename Function>
+void for_each_set_bit(const bitset_view<const uint64_t>& view, Function function) {
+  view.ones().for_each(function);
+}
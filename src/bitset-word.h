@@ -0,0 +1,268 @@
+#pragma once
+
+#include "bitset-dispatch.h"
+
+#include <bit>
+#include <climits>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <type_traits>
+
+// Word types the bits can be stored in. Whatever the width, the first bit of a word is its most significant one.
+namespace bitset_word {
+
+__extension__ typedef unsigned __int128 uint128;
+
+template <typename W>
+concept word = std::same_as<W, uint32_t> || std::same_as<W, uint64_t> || std::same_as<W, uint128>;
+
+template <typename W>
+inline constexpr std::size_t bits = sizeof(W) * CHAR_BIT;
+
+// The standard bit functions do not take `unsigned __int128` in strict mode, so 128-bit words go by halves.
+template <typename W>
+constexpr int popcount(W word) {
+  if constexpr (bits<W> > 64) {
+    return std::popcount(uint64_t(word >> 64)) + std::popcount(uint64_t(word));
+  } else {
+    return std::popcount(word);
+  }
+}
+
+template <typename W>
+constexpr int countl_zero(W word) {
+  if constexpr (bits<W> > 64) {
+    uint64_t high = uint64_t(word >> 64);
+    return (high != 0) ? std::countl_zero(high) : 64 + std::countl_zero(uint64_t(word));
+  } else {
+    return std::countl_zero(word);
+  }
+}
+
+template <typename W>
+constexpr int countr_zero(W word) {
+  if constexpr (bits<W> > 64) {
+    uint64_t low = uint64_t(word);
+    return (low != 0) ? std::countr_zero(low) : 64 + std::countr_zero(uint64_t(word >> 64));
+  } else {
+    return std::countr_zero(word);
+  }
+}
+
+namespace detail {
+
+// A range of 128-bit words is a range of 64-bit words with the halves of each word swapped. Loops that do not
+// depend on the order of the bits, i.e. everything but shifted operands and non-uniform patterns, run on the
+// dispatched 64-bit kernels over twice as many words. 32-bit words always take the scalar loops.
+template <typename W>
+inline constexpr std::size_t halves = sizeof(W) / sizeof(uint64_t);
+
+template <typename W>
+auto as_halves(W* words) {
+  return reinterpret_cast<std::conditional_t<std::is_const_v<W>, const uint64_t, uint64_t>*>(words);
+}
+
+template <typename W>
+bool is_uniform(W pattern) {
+  return pattern == 0 || pattern == W(~W(0));
+}
+
+template <typename W>
+W shifted(const W* src, std::size_t i, std::size_t shift) {
+  return W(src[i] << shift) | W(src[i + 1] >> (bits<W> - shift));
+}
+
+struct set_operation {
+  template <typename T>
+  T operator()(T /*a*/) const {
+    return ~T(0);
+  }
+};
+
+struct reset_operation {
+  template <typename T>
+  T operator()(T /*a*/) const {
+    return T(0);
+  }
+};
+
+struct andnot_operation {
+  template <typename T>
+  T operator()(T a, T b) const {
+    return a & ~b;
+  }
+};
+
+template <typename W, auto Kernel, typename Function>
+void binary_words(W* dst, const W* src, std::size_t count, std::size_t shift) {
+  Function operation;
+  if (shift == 0) {
+    if constexpr (halves<W> != 0) {
+      (bitset_simd::active_kernels().*Kernel)(as_halves(dst), as_halves(src), count * halves<W>, 0);
+    } else {
+      for (std::size_t i = 0; i < count; ++i) {
+        dst[i] = operation(dst[i], src[i]);
+      }
+    }
+    return;
+  }
+  for (std::size_t i = 0; i < count; ++i) {
+    dst[i] = operation(dst[i], shifted(src, i, shift));
+  }
+}
+
+template <typename W, auto Kernel, typename Function>
+void unary_words(W* dst, std::size_t count) {
+  if constexpr (halves<W> != 0) {
+    (bitset_simd::active_kernels().*Kernel)(as_halves(dst), count * halves<W>);
+  } else {
+    Function operation;
+    for (std::size_t i = 0; i < count; ++i) {
+      dst[i] = operation(dst[i]);
+    }
+  }
+}
+
+template <typename W>
+std::size_t count_words(const W* src, std::size_t count) {
+  if constexpr (halves<W> != 0) {
+    return bitset_simd::active_kernels().count_words(as_halves(src), count * halves<W>);
+  } else {
+    std::size_t result = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+      result += std::popcount(src[i]);
+    }
+    return result;
+  }
+}
+
+template <typename W, auto Kernel, typename Function>
+std::size_t count_binary_words(const W* lhs, const W* rhs, std::size_t count, std::size_t shift) {
+  if constexpr (halves<W> != 0) {
+    if (shift == 0) {
+      return (bitset_simd::active_kernels().*Kernel)(as_halves(lhs), as_halves(rhs), count * halves<W>, 0);
+    }
+  }
+  Function operation;
+  std::size_t result = 0;
+  for (std::size_t i = 0; i < count; ++i) {
+    result += popcount(W(operation(lhs[i], (shift == 0) ? rhs[i] : shifted(rhs, i, shift))));
+  }
+  return result;
+}
+
+template <typename W, auto Kernel, typename Function>
+bool any_binary_words(const W* lhs, const W* rhs, std::size_t count, std::size_t shift) {
+  if constexpr (halves<W> != 0) {
+    if (shift == 0) {
+      return (bitset_simd::active_kernels().*Kernel)(as_halves(lhs), as_halves(rhs), count * halves<W>, 0);
+    }
+  }
+  Function operation;
+  for (std::size_t i = 0; i < count; ++i) {
+    if (W(operation(lhs[i], (shift == 0) ? rhs[i] : shifted(rhs, i, shift))) != 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+template <typename W>
+bool match_words(const W* src, std::size_t count, W pattern) {
+  if constexpr (halves<W> != 0) {
+    if (is_uniform(pattern)) {
+      return bitset_simd::active_kernels().match_words(as_halves(src), count * halves<W>, uint64_t(pattern));
+    }
+  }
+  for (std::size_t i = 0; i < count; ++i) {
+    if (src[i] != pattern) {
+      return false;
+    }
+  }
+  return true;
+}
+
+template <typename W>
+bool equal_words(const W* lhs, const W* rhs, std::size_t count, std::size_t shift) {
+  if constexpr (halves<W> != 0) {
+    if (shift == 0) {
+      return bitset_simd::active_kernels().equal_words(as_halves(lhs), as_halves(rhs), count * halves<W>, 0);
+    }
+  }
+  for (std::size_t i = 0; i < count; ++i) {
+    if (lhs[i] != ((shift == 0) ? rhs[i] : shifted(rhs, i, shift))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+template <typename W>
+std::size_t find_words(const W* src, std::size_t count, W pattern) {
+  if constexpr (halves<W> != 0) {
+    if (is_uniform(pattern)) {
+      return bitset_simd::active_kernels().find_words(as_halves(src), count * halves<W>, uint64_t(pattern)) /
+             halves<W>;
+    }
+  }
+  for (std::size_t i = 0; i < count; ++i) {
+    if (src[i] != pattern) {
+      return i;
+    }
+  }
+  return count;
+}
+
+template <typename W>
+std::size_t find_last_words(const W* src, std::size_t count, W pattern) {
+  if constexpr (halves<W> != 0) {
+    if (is_uniform(pattern)) {
+      std::size_t found =
+          bitset_simd::active_kernels().find_last_words(as_halves(src), count * halves<W>, uint64_t(pattern));
+      return (found == count * halves<W>) ? count : found / halves<W>;
+    }
+  }
+  for (std::size_t i = count; i > 0; --i) {
+    if (src[i - 1] != pattern) {
+      return i - 1;
+    }
+  }
+  return count;
+}
+
+template <typename W>
+inline constexpr bitset_simd::basic_kernels<W> table = {
+    binary_words<W, &bitset_simd::kernels::and_words, std::bit_and<>>,
+    binary_words<W, &bitset_simd::kernels::or_words, std::bit_or<>>,
+    binary_words<W, &bitset_simd::kernels::xor_words, std::bit_xor<>>,
+    unary_words<W, &bitset_simd::kernels::flip_words, std::bit_not<>>,
+    unary_words<W, &bitset_simd::kernels::set_words, set_operation>,
+    unary_words<W, &bitset_simd::kernels::reset_words, reset_operation>,
+    count_words<W>,
+    match_words<W>,
+    equal_words<W>,
+    find_words<W>,
+    find_last_words<W>,
+    count_binary_words<W, &bitset_simd::kernels::and_count_words, std::bit_and<>>,
+    count_binary_words<W, &bitset_simd::kernels::or_count_words, std::bit_or<>>,
+    count_binary_words<W, &bitset_simd::kernels::xor_count_words, std::bit_xor<>>,
+    count_binary_words<W, &bitset_simd::kernels::andnot_count_words, andnot_operation>,
+    any_binary_words<W, &bitset_simd::kernels::and_any_words, std::bit_and<>>,
+    any_binary_words<W, &bitset_simd::kernels::andnot_any_words, andnot_operation>,
+};
+
+} // namespace detail
+
+// Kernels for views over words of type `W`: the dispatched ones for 64-bit words.
+template <typename W>
+const bitset_simd::basic_kernels<W>& kernels() noexcept {
+  if constexpr (std::same_as<W, uint64_t>) {
+    return bitset_simd::active_kernels();
+  } else {
+    return detail::table<W>;
+  }
+}
+
+} // namespace bitset_word
@@ -1,190 +1,545 @@
 #include "bitset.h"
+#include "bitset-serialization.h"
+#include "bitset-stats.h"
 
-bitset::bitset()
-    : _data{nullptr}
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <utility>
+
+template <typename W>
+basic_bitset<W>::basic_bitset()
+    : basic_bitset(allocator_type()) {}
+
+template <typename W>
+basic_bitset<W>::basic_bitset(const allocator_type& alloc)
+    : _data{_inline}
     , _size{0}
-    , _capacity{0} {}
+    , _inline{}
+    , _allocator{alloc} {}
 
-bitset::bitset(std::size_t size, bool value)
+template <typename W>
+basic_bitset<W>::basic_bitset(std::size_t size, bool value, const allocator_type& alloc)
     : _size(size)
-    , _capacity((size + word_size - 1) / word_size) {
-  if (size != 0) {
-    _data = static_cast<word_type*>(operator new(_capacity * sizeof(word_type)));
-    std::fill_n(_data, _capacity, ((value) ? ~word_type(0) : 0));
+    , _allocator(alloc) {
+  BITSET_STATS_SPAN(construct, size, bitset_stats::word_span(0, size, word_size));
+  allocate((size + word_size - 1) / word_size);
+  std::fill_n(_data, word_capacity(), ((value) ? ~word_type(0) : 0));
+}
+
+template <typename W>
+basic_bitset<W>::basic_bitset(const basic_bitset& other)
+    : basic_bitset(
+          other, std::allocator_traits<allocator_type>::select_on_container_copy_construction(other._allocator)
+      ) {}
+
+template <typename W>
+basic_bitset<W>::basic_bitset(const basic_bitset& other, const allocator_type& alloc)
+    : basic_bitset(other.begin(), other.end(), alloc) {}
+
+template <typename W>
+basic_bitset<W>::basic_bitset(basic_bitset&& other) noexcept
+    : basic_bitset(std::move(other), other._allocator) {}
+
+template <typename W>
+basic_bitset<W>::basic_bitset(basic_bitset&& other, const allocator_type& alloc)
+    : _size{other._size}
+    , _allocator{alloc} {
+  if (other.is_inline()) {
+    _data = _inline;
+    std::copy_n(other._inline, inline_words, _inline);
+  } else if (_allocator == other._allocator) {
+    _data = std::exchange(other._data, other._inline);
+    _capacity = other._capacity;
+    std::fill_n(other._inline, inline_words, 0);
   } else {
-    _data = nullptr;
+    allocate(other._capacity);
+    std::copy_n(other._data, other._capacity, _data);
   }
+  other._size = 0;
 }
 
-bitset::bitset(const bitset& other)
-    : bitset(other.begin(), other.end()) {}
-
-bitset::bitset(std::string_view str)
+template <typename W>
+basic_bitset<W>::basic_bitset(std::string_view str, const allocator_type& alloc)
     : _size(str.length())
-    , _capacity((_size + word_size - 1) / word_size) {
-  if (size() != 0) {
-    _data = static_cast<word_type*>(operator new(_capacity * sizeof(word_type)));
-    for (std::size_t i = 0; i < _capacity; ++i) {
-      word_type word = 0;
-      for (std::size_t j = 0; j < word_size && i * word_size + j < size(); ++j) {
-        if (str[i * word_size + j] == '1') {
-          word |= (word_type(1) << (word_size - 1 - j));
-        }
-      }
-      _data[i] = word;
-    }
-  } else {
-    _data = nullptr;
+    , _allocator(alloc) {
+  BITSET_STATS_SPAN(construct, _size, bitset_stats::word_span(0, _size, word_size));
+  std::size_t words = (_size + word_size - 1) / word_size;
+  allocate(words);
+  for (std::size_t i = 0; i < words; ++i) {
+    std::size_t count = std::min(word_size, _size - i * word_size);
+    _data[i] = bitset_text::parse_word<word_type>(str.data() + i * word_size, count);
   }
 }
 
-bitset::bitset(const const_view& other)
-    : bitset(other.begin(), other.end()) {}
+template <typename W>
+basic_bitset<W>::basic_bitset(const const_view& other, const allocator_type& alloc)
+    : basic_bitset(other.begin(), other.end(), alloc) {}
 
-bitset::bitset(bitset::const_iterator first, bitset::const_iterator last)
-    : bitset() {
-  bitset copy = bitset(last - first, false);
+template <typename W>
+basic_bitset<W>::basic_bitset(const_iterator first, const_iterator last, const allocator_type& alloc)
+    : basic_bitset(alloc) {
+  std::size_t bits = last - first;
+  BITSET_STATS_SPAN(copy, bits, bitset_stats::word_span(first.bit_offset(), bits, word_size));
+  basic_bitset copy = basic_bitset(bits, false, alloc);
   copy |= const_view(first, last);
   swap(copy);
 }
 
-bitset& bitset::operator=(const bitset& other) & {
+template <typename W>
+basic_bitset<W>& basic_bitset<W>::operator=(const basic_bitset& other) & {
   if (this == &other) {
     return *this;
   }
-  bitset copy(other);
+  basic_bitset copy(other, _allocator);
   swap(copy);
   return *this;
 }
 
-bitset& bitset::operator=(std::string_view str) & {
-  bitset copy(str);
+template <typename W>
+basic_bitset<W>& basic_bitset<W>::operator=(basic_bitset&& other) & {
+  basic_bitset moved(std::move(other), _allocator);
+  swap(moved);
+  return *this;
+}
+
+template <typename W>
+basic_bitset<W>& basic_bitset<W>::operator=(std::string_view str) & {
+  basic_bitset copy(str, _allocator);
   swap(copy);
   return *this;
 }
 
-bitset& bitset::operator=(const const_view& other) & {
-  bitset copy(other);
+template <typename W>
+basic_bitset<W>& basic_bitset<W>::operator=(const const_view& other) & {
+  basic_bitset copy(other, _allocator);
   swap(copy);
   return *this;
 }
 
-bitset::~bitset() {
-  if (_data != nullptr) {
-    std::reverse_iterator<word_type*> iter(_data + _capacity);
-    operator delete(_data);
+template <typename W>
+basic_bitset<W>::~basic_bitset() {
+  if (!is_inline()) {
+    _allocator.deallocate(_data, _capacity);
+    BITSET_STATS_DEALLOCATION();
   }
 }
 
-void bitset::swap(bitset& other) noexcept {
-  std::swap(_data, other._data);
+template <typename W>
+void basic_bitset<W>::swap(basic_bitset& other) {
+  if (_allocator != other._allocator) {
+    basic_bitset lhs(other, _allocator);
+    basic_bitset rhs(*this, other._allocator);
+    swap(lhs);
+    other.swap(rhs);
+    return;
+  }
+  if (is_inline() && other.is_inline()) {
+    std::swap(_inline, other._inline);
+  } else if (is_inline()) {
+    other.swap(*this);
+    return;
+  } else if (other.is_inline()) {
+    word_type* data = _data;
+    std::size_t capacity = _capacity;
+    _data = _inline;
+    std::copy_n(other._inline, inline_words, _inline);
+    other._data = data;
+    other._capacity = capacity;
+  } else {
+    std::swap(_data, other._data);
+    std::swap(_capacity, other._capacity);
+  }
   std::swap(_size, other._size);
-  std::swap(_capacity, other._capacity);
 }
 
-std::size_t bitset::size() const {
+template <typename W>
+typename basic_bitset<W>::allocator_type basic_bitset<W>::get_allocator() const {
+  return _allocator;
+}
+
+template <typename W>
+bool basic_bitset<W>::is_inline() const {
+  return _data == _inline;
+}
+
+template <typename W>
+std::size_t basic_bitset<W>::word_capacity() const {
+  return is_inline() ? inline_words : _capacity;
+}
+
+template <typename W>
+void basic_bitset<W>::allocate(std::size_t words) {
+  if (words <= inline_words) {
+    _data = _inline;
+    std::fill_n(_inline, inline_words, 0);
+  } else {
+    _data = _allocator.allocate(words);
+    _capacity = words;
+    BITSET_STATS_ALLOCATION(words * sizeof(word_type));
+  }
+}
+
+// Moves the first words to a buffer of `words` words, which is inline if it fits. Nothing changes if the
+// allocation throws.
+template <typename W>
+void basic_bitset<W>::reallocate(std::size_t words) {
+  word_type* old_data = _data;
+  std::size_t old_capacity = word_capacity();
+  bool was_inline = is_inline();
+  std::size_t used = std::min(words, (_size + word_size - 1) / word_size);
+  if (words <= inline_words) {
+    if (was_inline) {
+      return;
+    }
+    _data = _inline;
+    std::fill_n(_inline, inline_words, 0);
+    std::copy_n(old_data, used, _inline);
+  } else {
+    word_type* data = _allocator.allocate(words);
+    BITSET_STATS_ALLOCATION(words * sizeof(word_type));
+    std::copy_n(old_data, used, data);
+    _data = data;
+    _capacity = words;
+  }
+  if (!was_inline) {
+    _allocator.deallocate(old_data, old_capacity);
+    BITSET_STATS_DEALLOCATION();
+  }
+}
+
+// Makes room for `bits` bits, at least doubling the capacity when it has to grow.
+template <typename W>
+void basic_bitset<W>::grow(std::size_t bits) {
+  std::size_t words = (bits + word_size - 1) / word_size;
+  if (words > word_capacity()) {
+    reallocate(std::max(words, 2 * word_capacity()));
+  }
+}
+
+template <typename W>
+std::size_t basic_bitset<W>::size() const {
   return _size;
 }
 
-bool bitset::empty() const {
+template <typename W>
+bool basic_bitset<W>::empty() const {
   return _size == 0;
 }
 
-bitset::reference bitset::operator[](std::size_t index) {
+template <typename W>
+std::size_t basic_bitset<W>::capacity() const {
+  return word_capacity() * word_size;
+}
+
+template <typename W>
+void basic_bitset<W>::reserve(std::size_t bits) {
+  std::size_t words = (bits + word_size - 1) / word_size;
+  if (words > word_capacity()) {
+    reallocate(words);
+  }
+}
+
+template <typename W>
+void basic_bitset<W>::shrink_to_fit() {
+  std::size_t words = (_size + word_size - 1) / word_size;
+  if (!is_inline() && words < _capacity) {
+    reallocate(words);
+  }
+}
+
+template <typename W>
+typename basic_bitset<W>::reference basic_bitset<W>::operator[](std::size_t index) {
   return {
       index % word_size,
       _data + index / word_size,
   };
 }
 
-bitset::const_reference bitset::operator[](std::size_t index) const {
+template <typename W>
+typename basic_bitset<W>::const_reference basic_bitset<W>::operator[](std::size_t index) const {
   return {
       index % word_size,
       _data + index / word_size,
   };
 }
 
-bitset::iterator bitset::begin() {
+template <typename W>
+typename basic_bitset<W>::iterator basic_bitset<W>::begin() {
   return {_data, 0};
 }
 
-bitset::const_iterator bitset::begin() const {
+template <typename W>
+typename basic_bitset<W>::const_iterator basic_bitset<W>::begin() const {
   return {_data, 0};
 }
 
-bitset::iterator bitset::end() {
+template <typename W>
+typename basic_bitset<W>::iterator basic_bitset<W>::end() {
   return {_data + (_size / word_size), _size % word_size};
 }
 
-bitset::const_iterator bitset::end() const {
+template <typename W>
+typename basic_bitset<W>::const_iterator basic_bitset<W>::end() const {
   return {_data + (_size / word_size), _size % word_size};
 }
 
-bitset& bitset::operator&=(const const_view& other) & {
+template <typename W>
+basic_bitset<W>& basic_bitset<W>::operator&=(const const_view& other) & {
   view(*this) &= other;
   return *this;
 }
 
-bitset& bitset::operator|=(const const_view& other) & {
+template <typename W>
+basic_bitset<W>& basic_bitset<W>::operator|=(const const_view& other) & {
   view(*this) |= other;
   return *this;
 }
 
-bitset& bitset::operator^=(const const_view& other) & {
+template <typename W>
+basic_bitset<W>& basic_bitset<W>::operator^=(const const_view& other) & {
   view(*this) ^= other;
   return *this;
 }
 
-bitset& bitset::operator<<=(std::size_t count) & {
-  if (count + size() < _capacity) {
-    _size += count;
-    return *this;
-  }
-  bitset ans(size() + count, false);
-  ans.subview(0, size()) |= *this;
-  swap(ans);
+template <typename W>
+basic_bitset<W>& basic_bitset<W>::operator<<=(std::size_t count) & {
+  grow(_size + count);
+  std::size_t old_size = _size;
+  _size += count;
+  // Bits past the old end may still hold values from before a `>>=`.
+  subview(old_size).reset();
   return *this;
 }
 
-bitset& bitset::operator>>=(std::size_t count) & {
+template <typename W>
+basic_bitset<W>& basic_bitset<W>::operator>>=(std::size_t count) & {
   _size = (count >= size()) ? 0 : size() - count;
   return *this;
 }
 
-void bitset::flip() & {
+template <typename W>
+void basic_bitset<W>::push_back(bool value) {
+  grow(_size + 1);
+  (*this)[_size++] = value;
+}
+
+template <typename W>
+void basic_bitset<W>::append(const const_view& other) {
+  // The view may come from any buffer, and only `std::less` orders pointers into unrelated ones.
+  const word_type* first = other.begin()._word;
+  if (std::greater_equal<>()(first, _data) && std::less<>()(first, _data + word_capacity())) {
+    append(basic_bitset(other));
+    return;
+  }
+  std::size_t old_size = _size;
+  *this <<= other.size();
+  subview(old_size) |= other;
+}
+
+template <typename W>
+void basic_bitset<W>::append_word(word_type word, std::size_t count) {
+  if (count == 0) {
+    return;
+  }
+  grow(_size + count);
+  word_type bits = word << (word_size - count);
+  std::size_t offset = _size % word_size;
+  word_type* current = _data + _size / word_size;
+  if (offset == 0) {
+    *current = bits;
+  } else {
+    *current = (*current & ~(~word_type(0) >> offset)) | (bits >> offset);
+    if (offset + count > word_size) {
+      *(current + 1) = bits << (word_size - offset);
+    }
+  }
+  _size += count;
+}
+
+template <typename W>
+void basic_bitset<W>::resize(std::size_t size, bool value) {
+  if (size <= _size) {
+    _size = size;
+    return;
+  }
+  std::size_t old_size = _size;
+  *this <<= size - old_size;
+  if (value) {
+    subview(old_size).set();
+  }
+}
+
+template <typename W>
+void basic_bitset<W>::flip() & {
   view(*this).flip();
 }
 
-bitset& bitset::set() & {
+template <typename W>
+basic_bitset<W>& basic_bitset<W>::set() & {
   view(*this).set();
   return *this;
 }
 
-bitset& bitset::reset() & {
+template <typename W>
+basic_bitset<W>& basic_bitset<W>::reset() & {
   view(*this).reset();
   return *this;
 }
 
-bool bitset::all() const {
+template <typename W>
+bool basic_bitset<W>::all() const {
   return const_view(begin(), end()).all();
 }
 
-bool bitset::any() const {
+template <typename W>
+bool basic_bitset<W>::any() const {
   return const_view(begin(), end()).any();
 }
 
-std::size_t bitset::count() const {
+template <typename W>
+std::size_t basic_bitset<W>::count() const {
   return const_view(begin(), end()).count();
 }
 
-bitset::view bitset::subview(std::size_t offset, std::size_t count) {
+template <typename W>
+bitset_ones basic_bitset<W>::ones() const
+  requires std::same_as<W, uint64_t>
+{
+  return const_view(begin(), end()).ones();
+}
+
+template <typename W>
+std::size_t basic_bitset<W>::find_first() const {
+  return const_view(begin(), end()).find_first();
+}
+
+template <typename W>
+std::size_t basic_bitset<W>::find_next(std::size_t pos) const {
+  return const_view(begin(), end()).find_next(pos);
+}
+
+template <typename W>
+std::size_t basic_bitset<W>::find_last() const {
+  return const_view(begin(), end()).find_last();
+}
+
+template <typename W>
+std::size_t basic_bitset<W>::find_prev(std::size_t pos) const {
+  return const_view(begin(), end()).find_prev(pos);
+}
+
+template <typename W>
+std::size_t basic_bitset<W>::find_first_zero() const {
+  return const_view(begin(), end()).find_first_zero();
+}
+
+template <typename W>
+std::size_t basic_bitset<W>::find_next_zero(std::size_t pos) const {
+  return const_view(begin(), end()).find_next_zero(pos);
+}
+
+template <typename W>
+std::size_t basic_bitset<W>::find_last_zero() const {
+  return const_view(begin(), end()).find_last_zero();
+}
+
+template <typename W>
+std::size_t basic_bitset<W>::find_prev_zero(std::size_t pos) const {
+  return const_view(begin(), end()).find_prev_zero(pos);
+}
+
+template <typename W>
+typename basic_bitset<W>::view basic_bitset<W>::subview(std::size_t offset, std::size_t count) {
   return view(*this).subview(offset, count);
 }
 
-bitset::const_view bitset::subview(std::size_t offset, std::size_t count) const {
+template <typename W>
+typename basic_bitset<W>::const_view basic_bitset<W>::subview(std::size_t offset, std::size_t count) const {
   return const_view(*this).subview(offset, count);
 }
 
+template <typename W>
+void basic_bitset<W>::write(std::ostream& out) const
+  requires std::same_as<W, uint64_t>
+{
+  std::size_t words = bitset_format::word_count(_size);
+  word_type last_mask = (_size % word_size == 0) ? ~word_type(0) : ~word_type(0) << (word_size - _size % word_size);
+  bitset_format::header header = bitset_format::make_header(_size, _data, last_mask);
+  out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  if (words == 0) {
+    return;
+  }
+  out.write(reinterpret_cast<const char*>(_data), std::streamsize((words - 1) * sizeof(word_type)));
+  word_type last = _data[words - 1] & last_mask;
+  out.write(reinterpret_cast<const char*>(&last), sizeof(last));
+}
+
+template <typename W>
+basic_bitset<W> basic_bitset<W>::read(std::istream& in, const allocator_type& alloc)
+  requires std::same_as<W, uint64_t>
+{
+  bitset_format::header header;
+  if (!in.read(reinterpret_cast<char*>(&header), sizeof(header)) || !bitset_format::is_compatible(header)) {
+    in.setstate(std::ios::failbit);
+    return basic_bitset(alloc);
+  }
+  // The size is not trusted before the words arrive, so the buffer grows with what has been read: at most
+  // twice that plus one chunk is allocated before a short stream fails.
+  constexpr std::size_t chunk_words = std::size_t(1) << 16;
+  basic_bitset result(alloc);
+  std::size_t words = bitset_format::word_count(header.size);
+  for (std::size_t done = 0; done < words;) {
+    if (done == result.word_capacity()) {
+      result.reallocate(std::min(words, std::max(2 * done, chunk_words)));
+    }
+    std::size_t count = std::min(words, result.word_capacity()) - done;
+    if (!in.read(reinterpret_cast<char*>(result._data + done), std::streamsize(count * sizeof(word_type)))) {
+      break;
+    }
+    done += count;
+    result._size = done * word_size;
+  }
+  if (!in || bitset_format::checksum(header, result._data) != header.checksum) {
+    in.setstate(std::ios::failbit);
+    return basic_bitset(alloc);
+  }
+  result._size = header.size;
+  return result;
+}
+
+template <typename W>
+std::optional<typename basic_bitset<W>::const_view>
+basic_bitset<W>::from_buffer(std::span<const std::byte> buffer, bool verify)
+  requires std::same_as<W, uint64_t>
+{
+  if (reinterpret_cast<std::uintptr_t>(buffer.data()) % alignof(word_type) != 0 ||
+      buffer.size() < sizeof(bitset_format::header)) {
+    return std::nullopt;
+  }
+  bitset_format::header header;
+  std::memcpy(&header, buffer.data(), sizeof(header));
+  if (!bitset_format::is_compatible(header) || !bitset_format::is_complete(header, buffer.size())) {
+    return std::nullopt;
+  }
+  auto words = reinterpret_cast<const word_type*>(buffer.data() + sizeof(header));
+  if (verify && bitset_format::checksum(header, words) != header.checksum) {
+    return std::nullopt;
+  }
+  const_iterator first(words, 0);
+  return const_view(first, first + std::ptrdiff_t(header.size));
+}
+
+template <typename W>
+basic_bitset<W>::operator const_view() const {
+  return {begin(), end()};
+}
+
+template <typename W>
+basic_bitset<W>::operator view() {
+  return {begin(), end()};
+}
+
 std::string to_string(const bitset& bs) {
   return to_string(bs.subview());
 }
@@ -201,53 +556,102 @@ bitset operator>>(const bitset::const_view& bs, std::size_t count) {
   return copy;
 }
 
-bitset::operator const_view() const {
-  return {begin(), end()};
+bitset operator<<(bitset&& bs, std::size_t count) {
+  bs <<= count;
+  return std::move(bs);
 }
 
-bitset::operator view() {
-  return {begin(), end()};
+bitset operator>>(bitset&& bs, std::size_t count) {
+  bs >>= count;
+  return std::move(bs);
 }
 
 std::ostream& operator<<(std::ostream& out, const bitset& bs) {
-  for (auto b : bs) {
-    out << b;
+  return out << bs.subview();
+}
+
+bitset operator&(bitset&& lhs, const bitset::const_view& rhs) {
+  lhs &= rhs;
+  return std::move(lhs);
+}
+
+bitset operator|(bitset&& lhs, const bitset::const_view& rhs) {
+  lhs |= rhs;
+  return std::move(lhs);
+}
+
+bitset operator^(bitset&& lhs, const bitset::const_view& rhs) {
+  lhs ^= rhs;
+  return std::move(lhs);
+}
+
+bitset operator&(const bitset::const_view& lhs, bitset&& rhs) {
+  if (lhs.size() != rhs.size()) {
+    return bitset(lhs & std::as_const(rhs), rhs.get_allocator());
   }
-  return out;
+  return std::move(rhs) & lhs;
 }
 
-bitset operator&(const bitset::const_view& lhs, const bitset::const_view& rhs) {
-  bitset result(lhs);
-  result &= rhs;
-  return result;
+bitset operator|(const bitset::const_view& lhs, bitset&& rhs) {
+  if (lhs.size() != rhs.size()) {
+    return bitset(lhs | std::as_const(rhs), rhs.get_allocator());
+  }
+  return std::move(rhs) | lhs;
 }
 
-bitset operator|(const bitset::const_view& lhs, const bitset::const_view& rhs) {
-  bitset result(lhs);
-  result |= rhs;
-  return result;
+bitset operator^(const bitset::const_view& lhs, bitset&& rhs) {
+  if (lhs.size() != rhs.size()) {
+    return bitset(lhs ^ std::as_const(rhs), rhs.get_allocator());
+  }
+  return std::move(rhs) ^ lhs;
 }
 
-bitset operator^(const bitset::const_view& lhs, const bitset::const_view& rhs) {
-  bitset result(lhs);
-  result ^= rhs;
-  return result;
+bitset operator&(bitset&& lhs, bitset&& rhs) {
+  return std::move(lhs) & std::as_const(rhs);
 }
 
-bitset operator~(const bitset::const_view& view) {
-  bitset result(view);
-  result.flip();
-  return result;
+bitset operator|(bitset&& lhs, bitset&& rhs) {
+  return std::move(lhs) | std::as_const(rhs);
+}
+
+bitset operator^(bitset&& lhs, bitset&& rhs) {
+  return std::move(lhs) ^ std::as_const(rhs);
+}
+
+bitset operator~(bitset&& bs) {
+  bs.flip();
+  return std::move(bs);
+}
+
+std::size_t and_count(const bitset::const_view& lhs, const bitset::const_view& rhs) {
+  return lhs.and_count(rhs);
 }
 
-void swap(bitset& lhs, bitset& rhs) noexcept {
-  lhs.swap(rhs);
+std::size_t or_count(const bitset::const_view& lhs, const bitset::const_view& rhs) {
+  return lhs.or_count(rhs);
 }
 
-void swap(bitset::view& lhs, bitset::view& rhs) noexcept {
-  lhs.swap(rhs);
+std::size_t xor_count(const bitset::const_view& lhs, const bitset::const_view& rhs) {
+  return lhs.xor_count(rhs);
 }
 
-void swap(bitset::iterator& lhs, bitset::iterator& rhs) noexcept {
-  lhs.swap(rhs);
+std::size_t andnot_count(const bitset::const_view& lhs, const bitset::const_view& rhs) {
+  return lhs.andnot_count(rhs);
 }
+
+bool intersects(const bitset::const_view& lhs, const bitset::const_view& rhs) {
+  return lhs.intersects(rhs);
+}
+
+bool is_subset_of(const bitset::const_view& lhs, const bitset::const_view& rhs) {
+  return lhs.is_subset_of(rhs);
+}
+
+double jaccard(const bitset::const_view& lhs, const bitset::const_view& rhs) {
+  std::size_t together = lhs.or_count(rhs);
+  return (together == 0) ? 1.0 : double(lhs.and_count(rhs)) / double(together);
+}
+
+template class basic_bitset<uint32_t>;
+template class basic_bitset<uint64_t>;
+template class basic_bitset<bitset_word::uint128>;
@@ -1,21 +1,35 @@
 #pragma once
 
+#include "bitset-expression.h"
 #include "bitset-iterator.h"
 #include "bitset-reference.h"
 #include "bitset-view.h"
+#include "bitset-word.h"
 
 #include <algorithm>
+#include <concepts>
 #include <cstddef>
 #include <cstdint>
 #include <cstring>
 #include <format>
 #include <functional>
+#include <istream>
+#include <memory_resource>
+#include <optional>
 #include <ostream>
+#include <span>
 #include <string_view>
+#include <type_traits>
+#include <utility>
 
-class bitset {
+// Bits stored in words of type `W` (`uint32_t`, `uint64_t` or `bitset_word::uint128`). Serialization, `ones()`
+// and expressions need 64-bit words; with other words, the bitwise operators return bitsets.
+template <typename W>
+class basic_bitset {
 public:
-  using word_type = uint64_t;
+  static_assert(bitset_word::word<W>);
+
+  using word_type = W;
   using value_type = bool;
   using reference = bitset_reference<word_type>;
   using const_reference = bitset_reference<const word_type>;
@@ -23,29 +37,48 @@ public:
   using const_iterator = bitset_iterator<const word_type>;
   using view = bitset_view<word_type>;
   using const_view = bitset_view<const word_type>;
+  using allocator_type = std::pmr::polymorphic_allocator<word_type>;
 
   static constexpr std::size_t npos = -1;
-  static constexpr std::size_t word_size = 64;
+  static constexpr std::size_t word_size = bitset_word::bits<word_type>;
 
 public:
-  bitset();
-  bitset(std::size_t size, bool value);
-  bitset(const bitset& other);
-  explicit bitset(std::string_view str);
-  explicit bitset(const const_view& other);
-  bitset(const_iterator first, const_iterator last);
+  basic_bitset();
+  explicit basic_bitset(const allocator_type& alloc);
+  basic_bitset(std::size_t size, bool value, const allocator_type& alloc = allocator_type());
+  basic_bitset(const basic_bitset& other);
+  basic_bitset(const basic_bitset& other, const allocator_type& alloc);
+  basic_bitset(basic_bitset&& other) noexcept;
+  basic_bitset(basic_bitset&& other, const allocator_type& alloc);
+  explicit basic_bitset(std::string_view str, const allocator_type& alloc = allocator_type());
+  explicit basic_bitset(const const_view& other, const allocator_type& alloc = allocator_type());
+  basic_bitset(const_iterator first, const_iterator last, const allocator_type& alloc = allocator_type());
+
+  template <bitset_expression_type E>
+    requires std::same_as<W, uint64_t>
+  basic_bitset(const E& expr, const allocator_type& alloc = allocator_type());
 
-  bitset& operator=(const bitset& other) &;
-  bitset& operator=(std::string_view str) &;
-  bitset& operator=(const const_view& other) &;
+  // Like standard containers with a polymorphic allocator, assignment and swap keep the allocators of both
+  // sides; contents are copied when the allocators differ.
+  basic_bitset& operator=(const basic_bitset& other) &;
+  basic_bitset& operator=(basic_bitset&& other) &;
+  basic_bitset& operator=(std::string_view str) &;
+  basic_bitset& operator=(const const_view& other) &;
 
-  ~bitset();
+  ~basic_bitset();
 
-  void swap(bitset& other) noexcept;
+  void swap(basic_bitset& other);
+
+  allocator_type get_allocator() const;
 
   std::size_t size() const;
   bool empty() const;
 
+  // Capacity is counted in bits and grows geometrically, so repeated `<<=` is amortized O(count / 64).
+  std::size_t capacity() const;
+  void reserve(std::size_t bits);
+  void shrink_to_fit();
+
   reference operator[](std::size_t index);
   const_reference operator[](std::size_t index) const;
 
@@ -55,45 +88,345 @@ public:
   iterator end();
   const_iterator end() const;
 
-  bitset& operator&=(const const_view& other) &;
-  bitset& operator|=(const const_view& other) &;
-  bitset& operator^=(const const_view& other) &;
-  bitset& operator<<=(std::size_t count) &;
-  bitset& operator>>=(std::size_t count) &;
+  basic_bitset& operator&=(const const_view& other) &;
+  basic_bitset& operator|=(const const_view& other) &;
+  basic_bitset& operator^=(const const_view& other) &;
+
+  template <bitset_expression_type E>
+    requires std::same_as<W, uint64_t>
+  basic_bitset& operator&=(const E& other) &;
+  template <bitset_expression_type E>
+    requires std::same_as<W, uint64_t>
+  basic_bitset& operator|=(const E& other) &;
+  template <bitset_expression_type E>
+    requires std::same_as<W, uint64_t>
+  basic_bitset& operator^=(const E& other) &;
+
+  basic_bitset& operator<<=(std::size_t count) &;
+  basic_bitset& operator>>=(std::size_t count) &;
+
+  void push_back(bool value);
+  void append(const const_view& other);
+  // Appends the `count` low-order bits of `word`, most significant first; `count` is at most `word_size`.
+  void append_word(word_type word, std::size_t count);
+  void resize(std::size_t size, bool value = false);
 
   void flip() &;
-  bitset& set() &;
-  bitset& reset() &;
+  basic_bitset& set() &;
+  basic_bitset& reset() &;
 
   bool all() const;
   bool any() const;
   std::size_t count() const;
 
+  bitset_ones ones() const
+    requires std::same_as<W, uint64_t>;
+
+  std::size_t find_first() const;
+  std::size_t find_next(std::size_t pos) const;
+  std::size_t find_last() const;
+  std::size_t find_prev(std::size_t pos) const;
+  std::size_t find_first_zero() const;
+  std::size_t find_next_zero(std::size_t pos) const;
+  std::size_t find_last_zero() const;
+  std::size_t find_prev_zero(std::size_t pos) const;
+
   operator const_view() const;
   operator view();
 
   view subview(std::size_t offset = 0, std::size_t count = npos);
   const_view subview(std::size_t offset = 0, std::size_t count = npos) const;
 
+  // Binary format of `bitset-serialization.h`. `read` sets `failbit` and returns an empty bitset if the data is
+  // truncated, comes from an incompatible layout or fails the checksum.
+  void write(std::ostream& out) const
+    requires std::same_as<W, uint64_t>;
+  static basic_bitset read(std::istream& in, const allocator_type& alloc = allocator_type())
+    requires std::same_as<W, uint64_t>;
+
+  // View of a serialized bitset inside an 8-byte aligned `buffer` that outlives it; no words are copied.
+  static std::optional<const_view> from_buffer(std::span<const std::byte> buffer, bool verify = true)
+    requires std::same_as<W, uint64_t>;
+
 private:
+  static constexpr std::size_t inline_words = 2;
+
+  bool is_inline() const;
+  std::size_t word_capacity() const;
+  void allocate(std::size_t words);
+  void reallocate(std::size_t words);
+  void grow(std::size_t bits);
+
+  template <typename E, typename Function>
+  void apply_expression(const E& other, Function operation);
+
+  // Points either to `_inline` or to a heap buffer of `_capacity` words.
   word_type* _data;
   std::size_t _size;
-  std::size_t _capacity;
+
+  union {
+    std::size_t _capacity;
+    word_type _inline[inline_words];
+  };
+
+  allocator_type _allocator;
 };
 
-void swap(bitset& lhs, bitset& rhs) noexcept;
-void swap(bitset::view& lhs, bitset::view& rhs) noexcept;
-void swap(bitset::iterator& lhs, bitset::iterator& rhs) noexcept;
+using bitset = basic_bitset<uint64_t>;
+using bitset32 = basic_bitset<uint32_t>;
+using bitset128 = basic_bitset<bitset_word::uint128>;
+
+extern template class basic_bitset<uint32_t>;
+extern template class basic_bitset<uint64_t>;
+extern template class basic_bitset<bitset_word::uint128>;
+
+template <typename W>
+void swap(basic_bitset<W>& lhs, basic_bitset<W>& rhs) {
+  lhs.swap(rhs);
+}
+
+template <typename W>
+void swap(bitset_view<W>& lhs, bitset_view<W>& rhs) noexcept {
+  lhs.swap(rhs);
+}
+
+template <typename W>
+void swap(bitset_iterator<W>& lhs, bitset_iterator<W>& rhs) noexcept {
+  lhs.swap(rhs);
+}
 
 bool operator==(const bitset::const_view& left, const bitset::const_view& right);
 bool operator!=(const bitset::const_view& left, const bitset::const_view& right);
+bool operator==(const bitset32::const_view& left, const bitset32::const_view& right);
+bool operator!=(const bitset32::const_view& left, const bitset32::const_view& right);
+bool operator==(const bitset128::const_view& left, const bitset128::const_view& right);
+bool operator!=(const bitset128::const_view& left, const bitset128::const_view& right);
 
-bitset operator&(const bitset::const_view& lhs, const bitset::const_view& rhs);
-bitset operator|(const bitset::const_view& lhs, const bitset::const_view& rhs);
-bitset operator^(const bitset::const_view& lhs, const bitset::const_view& rhs);
-bitset operator~(const bitset::const_view& view);
+// Popcount reductions over `lhs` and the first `lhs.size()` bits of `rhs`, in one pass and without allocating.
+std::size_t and_count(const bitset::const_view& lhs, const bitset::const_view& rhs);
+std::size_t or_count(const bitset::const_view& lhs, const bitset::const_view& rhs);
+std::size_t xor_count(const bitset::const_view& lhs, const bitset::const_view& rhs);
+std::size_t andnot_count(const bitset::const_view& lhs, const bitset::const_view& rhs);
+bool intersects(const bitset::const_view& lhs, const bitset::const_view& rhs);
+bool is_subset_of(const bitset::const_view& lhs, const bitset::const_view& rhs);
+// `and_count / or_count`, or 1 when neither has a one.
+double jaccard(const bitset::const_view& lhs, const bitset::const_view& rhs);
+
+bitset operator&(bitset&& lhs, const bitset::const_view& rhs);
+bitset operator&(const bitset::const_view& lhs, bitset&& rhs);
+bitset operator&(bitset&& lhs, bitset&& rhs);
+bitset operator|(bitset&& lhs, const bitset::const_view& rhs);
+bitset operator|(const bitset::const_view& lhs, bitset&& rhs);
+bitset operator|(bitset&& lhs, bitset&& rhs);
+bitset operator^(bitset&& lhs, const bitset::const_view& rhs);
+bitset operator^(const bitset::const_view& lhs, bitset&& rhs);
+bitset operator^(bitset&& lhs, bitset&& rhs);
+bitset operator~(bitset&& bs);
 bitset operator<<(const bitset::const_view& bs, std::size_t count);
+bitset operator<<(bitset&& bs, std::size_t count);
 bitset operator>>(const bitset::const_view& bs, std::size_t count);
+bitset operator>>(bitset&& bs, std::size_t count);
 
 std::string to_string(const bitset& bs);
 std::ostream& operator<<(std::ostream& out, const bitset& bs);
+
+// The overloads above also take expressions, which convert to `bitset`.
+template <typename W>
+std::string to_string(const basic_bitset<W>& bs) {
+  return to_string(bs.subview());
+}
+
+template <typename W>
+std::ostream& operator<<(std::ostream& out, const basic_bitset<W>& bs) {
+  return out << bs.subview();
+}
+
+namespace bitset_detail {
+
+template <typename T>
+struct eager_word {};
+
+template <typename W>
+struct eager_word<basic_bitset<W>> {
+  using type = W;
+};
+
+template <typename U>
+struct eager_word<bitset_view<U>> {
+  using type = std::remove_const_t<U>;
+};
+
+template <typename T>
+using eager_word_t = typename eager_word<std::remove_cvref_t<T>>::type;
+
+// Bitsets and views of 32- or 128-bit words, which have no expressions: their operators evaluate into a new
+// bitset, or into the left operand when it is a temporary bitset.
+template <typename L, typename R>
+concept eager_operands = requires {
+  typename eager_word_t<L>;
+  typename eager_word_t<R>;
+} && std::same_as<eager_word_t<L>, eager_word_t<R>> && !std::same_as<eager_word_t<L>, uint64_t>;
+
+} // namespace bitset_detail
+
+template <typename L, typename R>
+  requires bitset_detail::eager_operands<L, R>
+basic_bitset<bitset_detail::eager_word_t<L>> operator&(L&& lhs, const R& rhs) {
+  basic_bitset<bitset_detail::eager_word_t<L>> result(std::forward<L>(lhs));
+  result &= rhs;
+  return result;
+}
+
+template <typename L, typename R>
+  requires bitset_detail::eager_operands<L, R>
+basic_bitset<bitset_detail::eager_word_t<L>> operator|(L&& lhs, const R& rhs) {
+  basic_bitset<bitset_detail::eager_word_t<L>> result(std::forward<L>(lhs));
+  result |= rhs;
+  return result;
+}
+
+template <typename L, typename R>
+  requires bitset_detail::eager_operands<L, R>
+basic_bitset<bitset_detail::eager_word_t<L>> operator^(L&& lhs, const R& rhs) {
+  basic_bitset<bitset_detail::eager_word_t<L>> result(std::forward<L>(lhs));
+  result ^= rhs;
+  return result;
+}
+
+template <typename T>
+  requires bitset_detail::eager_operands<T, T>
+basic_bitset<bitset_detail::eager_word_t<T>> operator~(T&& bs) {
+  basic_bitset<bitset_detail::eager_word_t<T>> result(std::forward<T>(bs));
+  result.flip();
+  return result;
+}
+
+template <typename T>
+  requires bitset_detail::eager_operands<T, T>
+basic_bitset<bitset_detail::eager_word_t<T>> operator<<(T&& bs, std::size_t count) {
+  basic_bitset<bitset_detail::eager_word_t<T>> result(std::forward<T>(bs));
+  result <<= count;
+  return result;
+}
+
+template <typename T>
+  requires bitset_detail::eager_operands<T, T>
+basic_bitset<bitset_detail::eager_word_t<T>> operator>>(T&& bs, std::size_t count) {
+  basic_bitset<bitset_detail::eager_word_t<T>> result(std::forward<T>(bs));
+  result >>= count;
+  return result;
+}
+
+// Unlike the constructor, which reads any character other than '1' as 0, these reject malformed input. Hex
+// packs four bits per digit and base64 (RFC 4648, padded) eight bits per byte, the first bit most significant,
+// and zero-fill the last digit or byte; `size` trims that fill and has to round up to the length of `str`.
+std::optional<bitset> from_string(std::string_view str, const bitset::allocator_type& alloc = {});
+std::string to_hex(const bitset::const_view& bs);
+std::optional<bitset>
+from_hex(std::string_view str, std::size_t size = bitset::npos, const bitset::allocator_type& alloc = {});
+std::string to_base64(const bitset::const_view& bs);
+std::optional<bitset>
+from_base64(std::string_view str, std::size_t size = bitset::npos, const bitset::allocator_type& alloc = {});
+
+template <typename W>
+template <bitset_expression_type E>
+  requires std::same_as<W, uint64_t>
+basic_bitset<W>::basic_bitset(const E& expr, const allocator_type& alloc)
+    : _size(expr.size())
+    , _allocator(alloc) {
+  allocate((_size + word_size - 1) / word_size);
+  expr.for_each_word([this, num = std::size_t(0)](word_type word, std::size_t /*count*/) mutable {
+    _data[num++] = word;
+    return true;
+  });
+}
+
+// Word `num` of an operand depends only on words `num` and later of the buffer it views, so an expression can
+// be evaluated straight into a bitset that it reads from.
+template <typename W>
+template <typename E, typename Function>
+void basic_bitset<W>::apply_expression(const E& other, Function operation) {
+  for (std::size_t num = 0; num * word_size < size(); ++num) {
+    _data[num] = operation(_data[num], other.get_word(num, std::min(word_size, size() - num * word_size)));
+  }
+}
+
+template <typename W>
+template <bitset_expression_type E>
+  requires std::same_as<W, uint64_t>
+basic_bitset<W>& basic_bitset<W>::operator&=(const E& other) & {
+  apply_expression(other, std::bit_and<>());
+  return *this;
+}
+
+template <typename W>
+template <bitset_expression_type E>
+  requires std::same_as<W, uint64_t>
+basic_bitset<W>& basic_bitset<W>::operator|=(const E& other) & {
+  apply_expression(other, std::bit_or<>());
+  return *this;
+}
+
+template <typename W>
+template <bitset_expression_type E>
+  requires std::same_as<W, uint64_t>
+basic_bitset<W>& basic_bitset<W>::operator^=(const E& other) & {
+  apply_expression(other, std::bit_xor<>());
+  return *this;
+}
+
+template <bitset_expression_type E>
+bitset operator&(bitset&& lhs, const E& rhs) {
+  lhs &= rhs;
+  return std::move(lhs);
+}
+
+template <bitset_expression_type E>
+bitset operator&(const E& lhs, bitset&& rhs) {
+  if (lhs.size() != rhs.size()) {
+    return bitset(lhs & std::as_const(rhs), rhs.get_allocator());
+  }
+  return std::move(rhs) & lhs;
+}
+
+template <bitset_expression_type E>
+bitset operator|(bitset&& lhs, const E& rhs) {
+  lhs |= rhs;
+  return std::move(lhs);
+}
+
+template <bitset_expression_type E>
+bitset operator|(const E& lhs, bitset&& rhs) {
+  if (lhs.size() != rhs.size()) {
+    return bitset(lhs | std::as_const(rhs), rhs.get_allocator());
+  }
+  return std::move(rhs) | lhs;
+}
+
+template <bitset_expression_type E>
+bitset operator^(bitset&& lhs, const E& rhs) {
+  lhs ^= rhs;
+  return std::move(lhs);
+}
+
+template <bitset_expression_type E>
+bitset operator^(const E& lhs, bitset&& rhs) {
+  if (lhs.size() != rhs.size()) {
+    return bitset(lhs ^ std::as_const(rhs), rhs.get_allocator());
+  }
+  return std::move(rhs) ^ lhs;
+}
+
+template <bitset_expression_type E>
+bitset operator<<(const E& expr, std::size_t count) {
+  bitset result(expr);
+  result <<= count;
+  return result;
+}
+
+template <bitset_expression_type E>
+bitset operator>>(const E& expr, std::size_t count) {
+  bitset result(expr);
+  result >>= count;
+  return result;
+}
@@ -0,0 +1,77 @@
+#include "bitset-atomic.h"
+#include "bitset.h"
+#include "test-helpers.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+TEST_CASE("atomic bitset operations") {
+  atomic_bitset bs(130);
+  CHECK(bs.size() == 130);
+  CHECK(bs.count() == 0);
+
+  CHECK_FALSE(bs.test_and_set(5));
+  CHECK(bs.test_and_set(5, std::memory_order_relaxed));
+  CHECK(bs.test(5));
+  CHECK(bs.test_and_reset(5, std::memory_order_acq_rel));
+  CHECK_FALSE(bs.test(5, std::memory_order_acquire));
+  CHECK_FALSE(bs.test_and_flip(129));
+  CHECK(bs.test(129));
+  bs.set(0);
+  bs.reset(129);
+  CHECK(bs.count() == 1);
+
+  CHECK(bs.fetch_or_range(60, 70) == 0);
+  CHECK(bs.fetch_or_range(0, 61) == 2);
+  CHECK(bs.count() == 130);
+  CHECK(bs.to_bitset() == bitset(130, true));
+
+  CHECK(bs.word_count() == 3);
+  bs.word(1).store(0);
+  CHECK(std::as_const(bs).load_word(1) == 0);
+  CHECK(bs.load_word(2, std::memory_order_relaxed) == ~(~uint64_t(0) >> 2));
+  CHECK(bs.count() == 66);
+}
+
+TEST_CASE("atomic bitset conversion") {
+  std::mt19937 rng(23);
+  std::string str = random_bit_string(300, rng);
+  bitset source(str);
+
+  atomic_bitset bs(source.subview(7));
+  CHECK(bs.to_bitset() == source.subview(7));
+  CHECK(bs.count() == source.subview(7).count());
+  CHECK(atomic_bitset(100, true).count() == 100);
+}
+
+TEST_CASE("atomic bitset concurrent claims") {
+  constexpr std::size_t size = 10000;
+  constexpr std::size_t threads = 4;
+  atomic_bitset bs(size);
+  std::atomic<std::size_t> claimed = 0;
+
+  std::vector<std::thread> workers;
+  for (std::size_t t = 0; t < threads; ++t) {
+    workers.emplace_back([&bs, &claimed, t] {
+      std::size_t mine = 0;
+      for (std::size_t i = 0; i < size; ++i) {
+        mine += !bs.test_and_set((i + t * 997) % size, std::memory_order_relaxed);
+      }
+      claimed += mine;
+    });
+  }
+  for (std::thread& worker : workers) {
+    worker.join();
+  }
+
+  CHECK(claimed == size);
+  CHECK(bs.count() == size);
+}
@@ -7,9 +7,36 @@
 #include <catch2/matchers/catch_matchers.hpp>
 
 #include <iostream>
+#include <memory_resource>
 #include <random>
 #include <sstream>
 #include <string>
+#include <utility>
+
+namespace {
+
+class counting_resource : public std::pmr::memory_resource {
+public:
+  std::size_t allocated = 0;
+  std::size_t deallocated = 0;
+
+private:
+  void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+    ++allocated;
+    return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+  }
+
+  void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override {
+    ++deallocated;
+    std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+  }
+
+  bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+    return this == &other;
+  }
+};
+
+} // namespace
 
 TEST_CASE("bitset default constructor") {
   bitset bs;
@@ -109,6 +136,100 @@ TEST_CASE("bitset copy constructor") {
   }
 }
 
+TEST_CASE("bitset move constructor") {
+  SECTION("empty") {
+    bitset bs;
+    bitset moved = std::move(bs);
+
+    CHECK(moved.empty());
+    CHECK(moved.begin() == moved.end());
+  }
+
+  SECTION("inline words") {
+    std::string_view str = "11110110111010000100101111101000011011111111000001100110010010001011100100110101";
+    bitset bs(str);
+    bitset moved = std::move(bs);
+
+    CHECK_THAT(moved, bitset_equals_string(str));
+    CHECK(bs.empty());
+  }
+
+  SECTION("heap words") {
+    std::string_view str = "11110110111010000100101111101000011011111111000001100110010010001011100100110101"
+                           "00011110011010000111001101110001001001001101001001001110010010110100110100111111"
+                           "10110010011101011000110100101100";
+    bitset bs(str);
+    bitset::const_iterator first = std::as_const(bs).begin();
+    bitset moved = std::move(bs);
+
+    CHECK_THAT(moved, bitset_equals_string(str));
+    CHECK(std::as_const(moved).begin() == first);
+    CHECK(bs.empty());
+  }
+}
+
+TEST_CASE("bitset move assignment") {
+  std::string_view str = "11110110111010000100101111101000011011111111000001100110010010001011100100110101"
+                         "00011110011010000111001101110001001001001101001001001110010010110100110100111111"
+                         "10110010011101011000110100101100";
+  bitset bs(str);
+  bitset::const_iterator first = std::as_const(bs).begin();
+
+  SECTION("to empty") {
+    bitset target;
+    target = std::move(bs);
+
+    CHECK_THAT(target, bitset_equals_string(str));
+    CHECK(std::as_const(target).begin() == first);
+  }
+
+  SECTION("to non-empty") {
+    bitset target("1101");
+    target = std::move(bs);
+
+    CHECK_THAT(target, bitset_equals_string(str));
+    CHECK(std::as_const(target).begin() == first);
+  }
+
+  SECTION("from inline words") {
+    bitset target("1101");
+    bs = std::move(target);
+
+    CHECK_THAT(bs, bitset_equals_string("1101"));
+  }
+
+  SECTION("self") {
+    bitset& self = bs;
+    bs = std::move(self);
+
+    CHECK_THAT(bs, bitset_equals_string(str));
+  }
+}
+
+TEST_CASE("bitset swap") {
+  std::string_view short_str = "1101101";
+  std::string_view long_str = "11110110111010000100101111101000011011111111000001100110010010001011100100110101"
+                              "00011110011010000111001101110001001001001101001001001110010010110100110100111111"
+                              "10110010011101011000110100101100";
+  std::string_view lhs_str = GENERATE_COPY(short_str, long_str);
+  std::string_view rhs_str = GENERATE_COPY(std::string_view("01"), long_str.substr(3));
+  CAPTURE(lhs_str, rhs_str);
+
+  bitset lhs(lhs_str);
+  bitset rhs(rhs_str);
+  swap(lhs, rhs);
+  CHECK_THAT(lhs, bitset_equals_string(rhs_str));
+  CHECK_THAT(rhs, bitset_equals_string(lhs_str));
+
+  lhs.subview(1, 1).flip();
+  rhs.subview(1, 1).flip();
+  swap(lhs, rhs);
+  CHECK(lhs.subview(2) == bitset(lhs_str.substr(2)));
+  CHECK(rhs.subview(2) == bitset(rhs_str.substr(2)));
+  CHECK(lhs[1] != (lhs_str[1] == '1'));
+  CHECK(rhs[1] != (rhs_str[1] == '1'));
+}
+
 TEST_CASE("bitset constructor from view") {
   SECTION("empty") {
     const bitset source("1101101");
@@ -147,6 +268,130 @@ TEST_CASE("bitset constructor from view") {
   }
 }
 
+TEST_CASE("bitset with memory resource") {
+  std::string_view str = "11110110111010000100101111101000011011111111000001100110010010001011100100110101"
+                         "00011110011010000111001101110001001001001101001001001110010010110100110100111111";
+  counting_resource resource;
+  counting_resource other_resource;
+  bitset::allocator_type alloc(&resource);
+  bitset::allocator_type other_alloc(&other_resource);
+
+  SECTION("construction") {
+    {
+      bitset bs(str, alloc);
+      CHECK(bs.get_allocator() == alloc);
+      CHECK(resource.allocated == 1);
+
+      bitset small(100, true, alloc);
+      CHECK(small.get_allocator() == alloc);
+      CHECK(resource.allocated == 1);
+    }
+    CHECK(resource.deallocated == 1);
+  }
+
+  SECTION("copy") {
+    const bitset bs(str, alloc);
+
+    bitset copy(bs);
+    CHECK(copy.get_allocator() == bitset::allocator_type());
+    CHECK(resource.allocated == 1);
+
+    bitset extended_copy(bs, other_alloc);
+    CHECK(extended_copy.get_allocator() == other_alloc);
+    CHECK_THAT(extended_copy, bitset_equals_string(str));
+    CHECK(other_resource.allocated == 1);
+
+    bitset assigned(other_alloc);
+    assigned = bs;
+    CHECK(assigned.get_allocator() == other_alloc);
+    CHECK_THAT(assigned, bitset_equals_string(str));
+  }
+
+  SECTION("move") {
+    bitset bs(str, alloc);
+    bitset moved(std::move(bs));
+    CHECK(moved.get_allocator() == alloc);
+    CHECK(resource.allocated == 1);
+
+    bitset extended_move(std::move(moved), other_alloc);
+    CHECK(extended_move.get_allocator() == other_alloc);
+    CHECK_THAT(extended_move, bitset_equals_string(str));
+    CHECK(other_resource.allocated == 1);
+
+    bitset assigned(alloc);
+    assigned = std::move(extended_move);
+    CHECK(assigned.get_allocator() == alloc);
+    CHECK_THAT(assigned, bitset_equals_string(str));
+    CHECK(resource.allocated == 2);
+  }
+
+  SECTION("swap") {
+    bitset lhs(str, alloc);
+    bitset rhs("1101", other_alloc);
+    swap(lhs, rhs);
+
+    CHECK(lhs.get_allocator() == alloc);
+    CHECK(rhs.get_allocator() == other_alloc);
+    CHECK_THAT(lhs, bitset_equals_string("1101"));
+    CHECK_THAT(rhs, bitset_equals_string(str));
+  }
+
+  SECTION("operators") {
+    const bitset rhs(str);
+    bitset result = ~(bitset(str, alloc) & rhs) | rhs;
+    CHECK(result.get_allocator() == alloc);
+    CHECK(result == (~(rhs & rhs) | rhs));
+
+    bitset evaluated(rhs ^ rhs, alloc);
+    CHECK(evaluated.get_allocator() == alloc);
+    CHECK_FALSE(evaluated.any());
+
+    bitset mismatched = rhs.subview(0, 10) & bitset(str, alloc);
+    CHECK(mismatched.get_allocator() == alloc);
+    CHECK_THAT(mismatched, bitset_equals_string(str.substr(0, 10)));
+  }
+}
+
+TEST_CASE("bitset capacity") {
+  counting_resource resource;
+  bitset bs{bitset::allocator_type(&resource)};
+  CHECK(bs.capacity() == 2 * bitset::word_size);
+
+  SECTION("reserve") {
+    bs.reserve(1000);
+    CHECK(bs.capacity() >= 1000);
+    CHECK(bs.empty());
+
+    std::size_t capacity = bs.capacity();
+    bs <<= 900;
+    CHECK(bs.capacity() == capacity);
+    CHECK(resource.allocated == 1);
+    CHECK_FALSE(bs.any());
+  }
+
+  SECTION("shrink_to_fit") {
+    bs <<= 1000;
+    bs.shrink_to_fit();
+    CHECK(bs.capacity() == 1024);
+
+    bs >>= 900;
+    bs.shrink_to_fit();
+    CHECK(bs.capacity() == 2 * bitset::word_size);
+    CHECK(bs.size() == 100);
+    CHECK(resource.allocated == resource.deallocated);
+  }
+
+  SECTION("geometric growth") {
+    for (std::size_t i = 0; i < 10000; ++i) {
+      bs <<= 1;
+      bs[i] = true;
+    }
+    CHECK(bs.size() == 10000);
+    CHECK(bs.all());
+    CHECK(resource.allocated < 10);
+  }
+}
+
 TEST_CASE("to_string(bitset)") {
   std::string_view str = "11010001001101000100110100010011010001001101000100110100010011010001001101000100";
   const bitset bs(str);
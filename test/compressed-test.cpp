@@ -0,0 +1,148 @@
+#include "bitset-compressed.h"
+#include "bitset.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include <cstddef>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace {
+
+constexpr std::size_t chunk_bits = compressed_bitset::chunk_bits;
+
+// Mixes sparse, dense and run-heavy chunks so that every container kind takes part.
+bitset make_mixed(std::size_t size, std::mt19937& rng) {
+  bitset bs(size, false);
+  std::bernoulli_distribution sparse(0.01);
+  std::bernoulli_distribution dense(0.6);
+  for (std::size_t i = 0; i < size; ++i) {
+    switch (i / chunk_bits % 4) {
+    case 0:
+      bs[i] = sparse(rng);
+      break;
+    case 1:
+      bs[i] = dense(rng);
+      break;
+    case 2:
+      bs[i] = (i / 1000 % 3 == 0);
+      break;
+    default:
+      break;
+    }
+  }
+  return bs;
+}
+
+} // namespace
+
+TEST_CASE("compressed bitset basics") {
+  compressed_bitset empty;
+  CHECK(empty.empty());
+  CHECK(empty.count() == 0);
+  CHECK_FALSE(empty.any());
+  CHECK(empty.to_bitset().empty());
+
+  compressed_bitset zeros(1000);
+  CHECK(zeros.size() == 1000);
+  CHECK(zeros.count() == 0);
+  CHECK_FALSE(zeros.contains(10));
+  CHECK(zeros.to_bitset() == bitset(1000, false));
+
+  bitset bs("0010010111");
+  compressed_bitset cbs(bs);
+  CHECK(cbs.size() == 10);
+  CHECK(cbs.count() == 5);
+  CHECK(cbs.contains(2));
+  CHECK_FALSE(cbs.contains(3));
+  CHECK_FALSE(cbs.contains(10));
+  CHECK(cbs.to_bitset() == bs);
+}
+
+TEST_CASE("compressed bitset round trip") {
+  std::mt19937 rng(13);
+  std::size_t size = GENERATE(chunk_bits - 1, chunk_bits, 5 * chunk_bits + 77);
+  std::size_t offset = GENERATE(0, 5);
+  CAPTURE(size, offset);
+
+  bitset source = make_mixed(size + offset, rng);
+  bitset::const_view view = source.subview(offset, size);
+  compressed_bitset cbs(view);
+
+  CHECK(cbs.size() == size);
+  CHECK(cbs.count() == view.count());
+  CHECK(cbs.to_bitset() == view);
+  for (std::size_t i = 0; i < size; i += 101) {
+    CHECK(cbs.contains(i) == view[i]);
+  }
+
+  std::vector<std::size_t> expected(view.ones().begin(), view.ones().end());
+  std::vector<std::size_t> actual;
+  for_each_set_bit(cbs, [&actual](std::size_t index) { actual.push_back(index); });
+  CHECK(actual == expected);
+}
+
+TEST_CASE("compressed bitset container choice") {
+  bitset bs(3 * chunk_bits, false);
+  for (std::size_t i = 0; i < chunk_bits; i += 100) {
+    bs[i] = true;
+  }
+  bs.subview(chunk_bits + 10, 30000).set();
+  for (std::size_t i = 2 * chunk_bits; i < 3 * chunk_bits; i += 2) {
+    bs[i] = true;
+  }
+  compressed_bitset cbs(bs);
+
+  CHECK(cbs.to_bitset() == bs);
+  CHECK(cbs.memory_usage() < bs.size() / 8);
+  CHECK(compressed_bitset(bs) == cbs);
+}
+
+TEST_CASE("compressed bitset operations") {
+  std::mt19937 rng(29);
+  std::size_t size = 6 * chunk_bits + 300;
+  bitset a = make_mixed(size, rng);
+  bitset b(size, false);
+  b.subview(chunk_bits / 2, 3 * chunk_bits).set();
+  b ^= make_mixed(size, rng);
+
+  compressed_bitset ca(a);
+  compressed_bitset cb(b);
+
+  SECTION("and") {
+    compressed_bitset result = ca & cb;
+    CHECK(result.to_bitset() == bitset(a & b));
+    CHECK(result == compressed_bitset(bitset(a & b)));
+  }
+
+  SECTION("or") {
+    compressed_bitset result = ca | cb;
+    CHECK(result.to_bitset() == bitset(a | b));
+    CHECK(result == compressed_bitset(bitset(a | b)));
+  }
+
+  SECTION("xor") {
+    compressed_bitset result = ca ^ cb;
+    CHECK(result.to_bitset() == bitset(a ^ b));
+    CHECK(result.count() == bitset(a ^ b).count());
+    CHECK(result == compressed_bitset(bitset(a ^ b)));
+  }
+
+  SECTION("self") {
+    compressed_bitset copy = ca;
+    copy ^= copy;
+    CHECK_FALSE(copy.any());
+    copy = ca;
+    copy &= copy;
+    CHECK(copy == ca);
+  }
+
+  SECTION("different sizes") {
+    compressed_bitset small(bitset(100, true));
+    compressed_bitset result = small | cb;
+    CHECK(result.size() == size);
+    CHECK(result.contains(99));
+  }
+}
@@ -0,0 +1,192 @@
+#include "bitset-dispatch.h"
+#include "bitset.h"
+#include "test-helpers.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include <algorithm>
+#include <random>
+#include <string>
+
+namespace {
+
+struct backend_guard {
+  bitset_simd::backend saved = bitset_simd::active_backend();
+
+  ~backend_guard() {
+    bitset_simd::select_backend(saved);
+  }
+};
+
+} // namespace
+
+TEST_CASE("backend selection") {
+  backend_guard guard;
+
+  CHECK(bitset_simd::is_supported(bitset_simd::backend::scalar));
+  CHECK(bitset_simd::is_supported(bitset_simd::best_backend()));
+  CHECK(bitset_simd::is_supported(bitset_simd::active_backend()));
+
+  auto value = GENERATE(
+      bitset_simd::backend::scalar,
+      bitset_simd::backend::simd128,
+      bitset_simd::backend::avx2,
+      bitset_simd::backend::avx512
+  );
+  CAPTURE(bitset_simd::to_string(value));
+
+  CHECK(bitset_simd::backend_from_string(bitset_simd::to_string(value)) == value);
+
+  bitset_simd::backend before = bitset_simd::active_backend();
+  if (bitset_simd::select_backend(value)) {
+    CHECK(bitset_simd::active_backend() == value);
+  } else {
+    CHECK_FALSE(bitset_simd::is_supported(value));
+    CHECK(bitset_simd::active_backend() == before);
+  }
+}
+
+TEST_CASE("backends agree") {
+  backend_guard guard;
+
+  auto value = GENERATE(
+      bitset_simd::backend::scalar,
+      bitset_simd::backend::simd128,
+      bitset_simd::backend::avx2,
+      bitset_simd::backend::avx512
+  );
+  if (!bitset_simd::select_backend(value)) {
+    SKIP();
+  }
+  CAPTURE(bitset_simd::to_string(value));
+
+  std::mt19937 rng(7);
+  std::string lhs_str = random_bit_string(3000, rng);
+  std::string rhs_str = random_bit_string(3000, rng);
+
+  std::size_t lhs_offset = GENERATE(0, 3, 64);
+  std::size_t rhs_offset = GENERATE(0, 3, 17);
+  std::size_t count = GENERATE(100, 2500);
+  CAPTURE(lhs_offset, rhs_offset, count);
+
+  bitset lhs(lhs_str);
+  bitset rhs(rhs_str);
+  bitset::view lhs_view = lhs.subview(lhs_offset, count);
+  bitset::view rhs_view = rhs.subview(rhs_offset, count);
+
+  SECTION("bitwise operations") {
+    lhs_view ^= rhs_view;
+    for (std::size_t i = 0; i < count; ++i) {
+      lhs_str[lhs_offset + i] = (lhs_str[lhs_offset + i] != rhs_str[rhs_offset + i]) ? '1' : '0';
+    }
+    CHECK_THAT(lhs, bitset_equals_string(lhs_str));
+  }
+
+  SECTION("count") {
+    auto first = lhs_str.begin() + std::ptrdiff_t(lhs_offset);
+    auto ones = std::count(first, first + std::ptrdiff_t(count), '1');
+    CHECK(lhs_view.count() == std::size_t(ones));
+  }
+
+  SECTION("all and any") {
+    CHECK(lhs_view.any());
+    CHECK_FALSE(lhs_view.all());
+
+    lhs_view.set();
+    CHECK(lhs_view.all());
+
+    lhs_view.reset();
+    CHECK_FALSE(lhs_view.any());
+
+    lhs[lhs_offset + count - 1] = true;
+    CHECK(lhs_view.any());
+  }
+
+  SECTION("find") {
+    lhs_view.reset();
+    CHECK(lhs_view.find_first() == bitset::npos);
+    CHECK(lhs_view.find_last() == bitset::npos);
+
+    lhs[lhs_offset + count - 2] = true;
+    lhs[lhs_offset + 1] = true;
+    CHECK(lhs_view.find_first() == 1);
+    CHECK(lhs_view.find_next(1) == count - 2);
+    CHECK(lhs_view.find_last() == count - 2);
+    CHECK(lhs_view.find_prev(count - 2) == 1);
+
+    lhs_view.flip();
+    CHECK(lhs_view.find_next_zero(1) == count - 2);
+    CHECK(lhs_view.find_prev_zero(count - 2) == 1);
+  }
+
+  SECTION("comparison") {
+    CHECK(lhs_view != rhs_view);
+
+    lhs_view.reset();
+    lhs_view |= rhs_view;
+    CHECK(lhs_view == rhs_view);
+
+    rhs[rhs_offset + count / 2].flip();
+    CHECK(lhs_view != rhs_view);
+  }
+}
+
+TEST_CASE("pair reductions agree") {
+  backend_guard guard;
+
+  auto value = GENERATE(
+      bitset_simd::backend::scalar,
+      bitset_simd::backend::simd128,
+      bitset_simd::backend::avx2,
+      bitset_simd::backend::avx512
+  );
+  if (!bitset_simd::select_backend(value)) {
+    SKIP();
+  }
+  CAPTURE(bitset_simd::to_string(value));
+
+  // Long enough for several Harley-Seal chunks of 512-bit blocks.
+  std::mt19937 rng(11);
+  std::string lhs_str = random_bit_string(40000, rng);
+  std::string rhs_str = random_bit_string(40000, rng);
+
+  std::size_t lhs_offset = GENERATE(0, 3, 64);
+  std::size_t rhs_offset = GENERATE(0, 3, 17);
+  std::size_t count = GENERATE(1, 100, 39000);
+  CAPTURE(lhs_offset, rhs_offset, count);
+
+  const bitset lhs(lhs_str);
+  const bitset rhs(rhs_str);
+  bitset::const_view lhs_view = lhs.subview(lhs_offset, count);
+  bitset::const_view rhs_view = rhs.subview(rhs_offset, count);
+
+  std::size_t both = 0;
+  std::size_t either = 0;
+  std::size_t different = 0;
+  std::size_t only_lhs = 0;
+  for (std::size_t i = 0; i < count; ++i) {
+    bool a = lhs_str[lhs_offset + i] == '1';
+    bool b = rhs_str[rhs_offset + i] == '1';
+    both += a && b;
+    either += a || b;
+    different += a != b;
+    only_lhs += a && !b;
+  }
+  CHECK(lhs_view.and_count(rhs_view) == both);
+  CHECK(lhs_view.or_count(rhs_view) == either);
+  CHECK(lhs_view.xor_count(rhs_view) == different);
+  CHECK(lhs_view.andnot_count(rhs_view) == only_lhs);
+  CHECK(lhs_view.intersects(rhs_view) == (both != 0));
+  CHECK(lhs_view.is_subset_of(rhs_view) == (only_lhs == 0));
+  CHECK(lhs_view.is_subset_of(lhs_view));
+
+  bitset subset(lhs_view & rhs_view);
+  CHECK(subset.subview().is_subset_of(rhs_view));
+  CHECK(subset.subview().is_subset_of(lhs_view));
+  CHECK(subset.subview().intersects(lhs_view) == (both != 0));
+  subset.subview().reset();
+  CHECK_FALSE(subset.subview().intersects(rhs_view));
+  subset[count - 1] = true;
+  CHECK(subset.subview().intersects(rhs_view) == (rhs_str[rhs_offset + count - 1] == '1'));
+}
@@ -0,0 +1,113 @@
+#include "bitset.h"
+#include "test-helpers.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <random>
+#include <string>
+#include <string_view>
+
+namespace {
+
+std::string sparse_bit_string(std::size_t size, std::size_t ones, std::mt19937& rng) {
+  std::string str(size, '0');
+  std::uniform_int_distribution<std::size_t> position(0, size - 1);
+  for (std::size_t i = 0; i < ones; ++i) {
+    str[position(rng)] = '1';
+  }
+  return str;
+}
+
+std::size_t expected_next(std::string_view str, std::size_t from, char bit) {
+  for (std::size_t i = from; i < str.size(); ++i) {
+    if (str[i] == bit) {
+      return i;
+    }
+  }
+  return bitset::npos;
+}
+
+std::size_t expected_prev(std::string_view str, std::size_t to, char bit) {
+  for (std::size_t i = std::min(to, str.size()); i > 0; --i) {
+    if (str[i - 1] == bit) {
+      return i - 1;
+    }
+  }
+  return bitset::npos;
+}
+
+} // namespace
+
+TEST_CASE("find on empty bitset") {
+  bitset bs;
+
+  CHECK(bs.find_first() == bitset::npos);
+  CHECK(bs.find_last() == bitset::npos);
+  CHECK(bs.find_next(0) == bitset::npos);
+  CHECK(bs.find_prev(0) == bitset::npos);
+  CHECK(bs.find_first_zero() == bitset::npos);
+  CHECK(bs.find_last_zero() == bitset::npos);
+}
+
+TEST_CASE("find in small bitset") {
+  bitset bs("0010010");
+
+  CHECK(bs.find_first() == 2);
+  CHECK(bs.find_next(2) == 5);
+  CHECK(bs.find_next(5) == bitset::npos);
+  CHECK(bs.find_next(bitset::npos) == bitset::npos);
+  CHECK(bs.find_last() == 5);
+  CHECK(bs.find_prev(5) == 2);
+  CHECK(bs.find_prev(2) == bitset::npos);
+  CHECK(bs.find_prev(bitset::npos) == 5);
+
+  CHECK(bs.find_first_zero() == 0);
+  CHECK(bs.find_next_zero(2) == 3);
+  CHECK(bs.find_last_zero() == 6);
+  CHECK(bs.find_prev_zero(6) == 4);
+}
+
+TEST_CASE("find matches bit-by-bit scan") {
+  std::mt19937 rng(5);
+  std::size_t ones = GENERATE(0, 1, 3, 40);
+  std::string str = sparse_bit_string(2000, ones, rng);
+
+  std::size_t offset = GENERATE(0, 1, 64, 77);
+  std::size_t count = GENERATE(1, 63, 64, 130, 1900);
+  CAPTURE(ones, offset, count);
+
+  bitset bs(str);
+  bitset::const_view view = bs.subview(offset, count);
+  std::string view_str = str.substr(offset, count);
+
+  SECTION("set bits") {
+    CHECK(view.find_first() == expected_next(view_str, 0, '1'));
+    CHECK(view.find_last() == expected_prev(view_str, count, '1'));
+    for (std::size_t pos = 0; pos < count; pos += 7) {
+      CHECK(view.find_next(pos) == expected_next(view_str, pos + 1, '1'));
+      CHECK(view.find_prev(pos) == expected_prev(view_str, pos, '1'));
+    }
+  }
+
+  SECTION("zero bits") {
+    bs.flip();
+    CHECK(view.find_first_zero() == expected_next(view_str, 0, '1'));
+    CHECK(view.find_last_zero() == expected_prev(view_str, count, '1'));
+    for (std::size_t pos = 0; pos < count; pos += 7) {
+      CHECK(view.find_next_zero(pos) == expected_next(view_str, pos + 1, '1'));
+      CHECK(view.find_prev_zero(pos) == expected_prev(view_str, pos, '1'));
+    }
+  }
+
+  SECTION("walk") {
+    std::size_t found = 0;
+    for (std::size_t pos = view.find_first(); pos != bitset::npos; pos = view.find_next(pos)) {
+      CHECK(view_str[pos] == '1');
+      ++found;
+    }
+    CHECK(found == view.count());
+  }
+}
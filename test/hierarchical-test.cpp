@@ -0,0 +1,67 @@
+#include "bitset-hierarchical.h"
+#include "bitset.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include <cstddef>
+#include <random>
+#include <vector>
+
+TEST_CASE("hierarchical bitset on empty and small sets") {
+  hierarchical_bitset empty;
+  CHECK_FALSE(empty.any());
+  CHECK(empty.find_first() == hierarchical_bitset::npos);
+
+  hierarchical_bitset bs(bitset("0010010"));
+  CHECK(bs.any());
+  CHECK(bs.find_first() == 2);
+  CHECK(bs.find_next(2) == 5);
+  CHECK(bs.find_next(5) == hierarchical_bitset::npos);
+  CHECK(bs.find_next(hierarchical_bitset::npos) == hierarchical_bitset::npos);
+
+  bs[2] = false;
+  bs[5].flip();
+  CHECK_FALSE(bs.any());
+  bs.set(6);
+  CHECK(bs.find_first() == 6);
+}
+
+TEST_CASE("hierarchical bitset matches a plain bitset") {
+  std::size_t size = GENERATE(64, 4097, 64 * 64 * 70 + 13);
+  CAPTURE(size);
+  std::mt19937 rng(31);
+  std::uniform_int_distribution<std::size_t> position(0, size - 1);
+
+  bitset expected(size, false);
+  for (std::size_t i = 0; i < 20; ++i) {
+    expected[position(rng)] = true;
+  }
+  hierarchical_bitset bs(expected);
+  CHECK(bs.base() == expected);
+
+  for (std::size_t step = 0; step < 200; ++step) {
+    std::size_t index = position(rng);
+    bool value = step % 3 == 0;
+    bs[index] = value;
+    expected[index] = value;
+
+    std::size_t from = position(rng);
+    CHECK(bs.find_next(from) == expected.find_next(from));
+  }
+
+  CHECK(bs.base() == expected);
+  CHECK(bs.count() == expected.count());
+  CHECK(bs.any() == expected.any());
+  CHECK(bs.find_first() == expected.find_first());
+
+  std::vector<std::size_t> visited;
+  for_each_set_bit(bs, [&visited](std::size_t index) { visited.push_back(index); });
+  CHECK(visited == std::vector<std::size_t>(expected.ones().begin(), expected.ones().end()));
+
+  for (std::size_t index : visited) {
+    bs.reset(index);
+  }
+  CHECK_FALSE(bs.any());
+  CHECK(bs.find_first() == hierarchical_bitset::npos);
+}
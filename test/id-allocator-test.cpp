@@ -0,0 +1,93 @@
+#include "bitset-id-allocator.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <set>
+#include <thread>
+#include <vector>
+
+TEST_CASE("id allocator hands out every id once") {
+  std::size_t capacity = GENERATE(0, 1, 64, 65, 4096, 64 * 64 * 3 + 5);
+  CAPTURE(capacity);
+  id_allocator allocator(capacity);
+  CHECK(allocator.capacity() == capacity);
+
+  std::set<std::size_t> ids;
+  for (std::size_t i = 0; i < capacity; ++i) {
+    std::size_t id = allocator.acquire();
+    REQUIRE(id < capacity);
+    CHECK(allocator.is_acquired(id));
+    ids.insert(id);
+  }
+  CHECK(ids.size() == capacity);
+  CHECK(allocator.count() == capacity);
+  CHECK(allocator.acquire() == id_allocator::npos);
+
+  if (capacity != 0) {
+    std::size_t released = capacity / 2;
+    allocator.release(released);
+    CHECK_FALSE(allocator.is_acquired(released));
+    CHECK(allocator.acquire() == released);
+    CHECK(allocator.acquire() == id_allocator::npos);
+  }
+
+  for (std::size_t id : ids) {
+    allocator.release(id);
+  }
+  CHECK(allocator.count() == 0);
+  CHECK((allocator.acquire() != id_allocator::npos) == (capacity != 0));
+}
+
+TEST_CASE("id allocator under contention") {
+  constexpr std::size_t capacity = 5000;
+  constexpr std::size_t threads = 4;
+  constexpr std::size_t rounds = 20000;
+  id_allocator allocator(capacity);
+  auto owners = std::make_unique<std::atomic<int>[]>(capacity);
+  std::atomic<std::size_t> conflicts = 0;
+
+  std::vector<std::thread> workers;
+  for (std::size_t t = 0; t < threads; ++t) {
+    workers.emplace_back([&, t] {
+      std::vector<std::size_t> held;
+      for (std::size_t i = 0; i < rounds; ++i) {
+        if (held.size() < 1000 && (i + t) % 3 != 0) {
+          std::size_t id = allocator.acquire();
+          if (id == id_allocator::npos) {
+            continue;
+          }
+          if (owners[id].exchange(1) != 0) {
+            ++conflicts;
+          }
+          held.push_back(id);
+        } else if (!held.empty()) {
+          std::size_t id = held.back();
+          held.pop_back();
+          owners[id].store(0);
+          allocator.release(id);
+        }
+      }
+      for (std::size_t id : held) {
+        owners[id].store(0);
+        allocator.release(id);
+      }
+    });
+  }
+  for (std::thread& worker : workers) {
+    worker.join();
+  }
+
+  CHECK(conflicts == 0);
+  CHECK(allocator.count() == 0);
+
+  std::set<std::size_t> ids;
+  for (std::size_t i = 0; i < capacity; ++i) {
+    ids.insert(allocator.acquire());
+  }
+  CHECK(ids.size() == capacity);
+  CHECK(ids.count(id_allocator::npos) == 0);
+}
@@ -5,8 +5,13 @@
 #include <catch2/generators/catch_generators.hpp>
 #include <catch2/matchers/catch_matchers_range_equals.hpp>
 
+#include <concepts>
+#include <iterator>
+#include <memory>
 #include <ranges>
+#include <string_view>
 #include <utility>
+#include <vector>
 
 TEST_CASE("bitset forward iteration") {
   SECTION("empty") {
@@ -128,3 +133,70 @@ TEST_CASE("empty subviews are equal") {
   const bitset bs_2("110101");
   CHECK(bs_1.subview(0, 0) == bs_2.subview(bs_2.size(), 0));
 }
+
+TEST_CASE("set bit iteration") {
+  STATIC_CHECK(std::forward_iterator<bitset_ones::iterator>);
+  STATIC_CHECK(std::ranges::forward_range<bitset_ones>);
+  STATIC_CHECK(std::same_as<std::iterator_traits<bitset_ones::iterator>::iterator_category, std::input_iterator_tag>);
+
+  SECTION("iterators outlive the range") {
+    const bitset bs("0010000001");
+    auto it = bs.ones().begin();
+    auto last = bs.ones().end();
+    CHECK(*it == 2);
+    CHECK(*++it == 9);
+    CHECK(++it == last);
+
+    auto ones = std::make_unique<bitset_ones>(bs.ones());
+    auto first = ones->begin();
+    bitset_ones copy = *ones;
+    ones.reset();
+    CHECK(*first == 2);
+    CHECK(first == copy.begin());
+  }
+
+  SECTION("empty") {
+    bitset bs;
+    CHECK(bs.ones().begin() == bs.ones().end());
+    CHECK(bitset(100, false).ones().empty());
+  }
+
+  SECTION("views") {
+    std::string_view str = "11110110111010000100101111101000011011111111000001100110010010001011100100110101"
+                           "00011110011010000111001101110001001001001101001001001110010010110100110100111111";
+    const bitset bs(str);
+
+    std::size_t offset = GENERATE(0, 1, 63, 64, 100);
+    std::size_t count = GENERATE(0, 1, 50, 64, 60);
+    CAPTURE(offset, count);
+
+    bitset::const_view view = bs.subview(offset, count);
+    std::vector<std::size_t> expected;
+    for (std::size_t i = 0; i < view.size(); ++i) {
+      if (str[offset + i] == '1') {
+        expected.push_back(i);
+      }
+    }
+
+    CHECK_THAT(view.ones(), Catch::Matchers::RangeEquals(expected));
+
+    std::vector<std::size_t> visited;
+    for_each_set_bit(view, [&](std::size_t index) { visited.push_back(index); });
+    CHECK(visited == expected);
+  }
+
+  SECTION("whole bitset") {
+    bitset bs(200, false);
+    bs[0] = true;
+    bs[63] = true;
+    bs[64] = true;
+    bs[199] = true;
+
+    std::vector<std::size_t> expected = {0, 63, 64, 199};
+    CHECK_THAT(bs.ones(), Catch::Matchers::RangeEquals(expected));
+
+    std::vector<std::size_t> visited;
+    for_each_set_bit(bs, [&](std::size_t index) { visited.push_back(index); });
+    CHECK(visited == expected);
+  }
+}
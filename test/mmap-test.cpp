@@ -0,0 +1,141 @@
+#include "bitset-mmap.h"
+#include "bitset-serialization.h"
+#include "bitset.h"
+#include "test-helpers.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+#include <utility>
+
+#include <unistd.h>
+
+namespace {
+
+// Named after the process and a random number, so that test binaries running at once do not share files.
+std::string temporary_path() {
+  std::string name = "bitset-mmap-test-" + std::to_string(::getpid()) + "-" + std::to_string(std::random_device()());
+  return (std::filesystem::temp_directory_path() / (name + ".bin")).string();
+}
+
+struct temporary_file {
+  std::string path = temporary_path();
+
+  ~temporary_file() {
+    std::filesystem::remove(path);
+  }
+};
+
+} // namespace
+
+TEST_CASE("mmap bitset") {
+  temporary_file file;
+  std::mt19937 rng(41);
+  std::string str = random_bit_string(1000, rng);
+
+  SECTION("create and reopen") {
+    {
+      mmap_bitset bs;
+      REQUIRE(bs.create(file.path, 1000));
+      CHECK(bs.is_writable());
+      CHECK(bs.size() == 1000);
+      CHECK_FALSE(bs.view().any());
+
+      bs.view() |= bitset(str);
+      CHECK(bs.advise(mmap_bitset::advice::sequential));
+      CHECK(bs.flush());
+    }
+
+    mmap_bitset bs;
+    REQUIRE(bs.open(file.path));
+    CHECK_FALSE(bs.is_writable());
+    CHECK(bs.verify());
+    CHECK_THAT(bitset(std::as_const(bs).view()), bitset_equals_string(str));
+    CHECK(std::as_const(bs).view().subview(10, 100).count() == bitset(str).subview(10, 100).count());
+    CHECK(bs.view().empty());
+    bs.view().set();
+    CHECK(std::as_const(bs).view().size() == 1000);
+
+    std::ifstream in(file.path, std::ios::binary);
+    CHECK_THAT(bitset::read(in), bitset_equals_string(str));
+  }
+
+  SECTION("open a written bitset") {
+    {
+      std::ofstream out(file.path, std::ios::binary);
+      bitset(str).write(out);
+    }
+    mmap_bitset bs;
+    REQUIRE(bs.open(file.path, mmap_bitset::mode::read_write));
+    CHECK(bs.verify());
+    bs.view().flip();
+    mmap_bitset moved(std::move(bs));
+    CHECK_FALSE(bs.is_open());
+    moved.close();
+
+    std::ifstream in(file.path, std::ios::binary);
+    CHECK(bitset::read(in) == ~bitset(str));
+  }
+
+  SECTION("grow") {
+    mmap_bitset bs;
+    REQUIRE(bs.create(file.path, 70));
+    bs.view().set();
+    REQUIRE(bs.grow(5000));
+    CHECK(bs.size() == 5000);
+    CHECK(bs.view().count() == 70);
+    CHECK(bs.view().subview(0, 70).all());
+    CHECK(bs.verify());
+    CHECK_FALSE(bs.grow(10));
+  }
+
+  SECTION("failures") {
+    mmap_bitset bs;
+    CHECK_FALSE(bs.open(file.path + ".missing"));
+    CHECK_FALSE(bs.is_open());
+
+    {
+      std::ofstream out(file.path, std::ios::binary);
+      out << "not a bitset, but longer than a header";
+    }
+    CHECK_FALSE(bs.open(file.path));
+    CHECK_FALSE(bs.open(file.path, mmap_bitset::mode::read_write));
+    {
+      std::ifstream in(file.path);
+      std::string content;
+      std::getline(in, content);
+      CHECK(content == "not a bitset, but longer than a header");
+    }
+
+    REQUIRE(bs.create(file.path, 10));
+    mmap_bitset read_only;
+    REQUIRE(read_only.open(file.path));
+    CHECK_FALSE(read_only.grow(100));
+    CHECK_FALSE(read_only.flush());
+    CHECK_FALSE(bs.create(file.path + ".huge", bitset_format::max_size + 1));
+  }
+
+  SECTION("corrupt size") {
+    // A size that wraps the word count.
+    bitset_format::header header = bitset_format::make_header(0, nullptr);
+    header.size = std::size_t(-11);
+    {
+      std::ofstream out(file.path, std::ios::binary);
+      out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    }
+    mmap_bitset bs;
+    CHECK_FALSE(bs.open(file.path));
+
+    header.size = 65;
+    {
+      std::ofstream out(file.path, std::ios::binary);
+      out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+      out.write(std::string(8, '\0').data(), 8);
+    }
+    CHECK_FALSE(bs.open(file.path));
+  }
+}
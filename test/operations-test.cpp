@@ -8,6 +8,9 @@
 #include <algorithm>
 #include <array>
 #include <iostream>
+#include <random>
+#include <string>
+#include <type_traits>
 #include <utility>
 
 TEST_CASE("left shift") {
@@ -63,6 +66,75 @@ TEST_CASE("left shift") {
   }
 }
 
+TEST_CASE("left shift after right shift") {
+  std::size_t shift_count = GENERATE(1, 30, 150, 300);
+  CAPTURE(shift_count);
+
+  bitset bs(std::string(200, '1'));
+  bs >>= shift_count;
+  bs <<= shift_count;
+
+  std::size_t kept = 200 - std::min<std::size_t>(shift_count, 200);
+  CHECK_THAT(bs, bitset_equals_string(std::string(kept, '1') + std::string(shift_count, '0')));
+}
+
+TEST_CASE("append") {
+  std::mt19937 rng(11);
+  std::string str = random_bit_string(500, rng);
+  bitset bs;
+  std::string expected;
+
+  SECTION("push_back") {
+    for (char c : str) {
+      bs.push_back(c == '1');
+    }
+    CHECK_THAT(bs, bitset_equals_string(str));
+  }
+
+  SECTION("append view") {
+    bitset source(str);
+    std::size_t offset = GENERATE(0, 1, 63, 64, 100);
+    CAPTURE(offset);
+
+    bs.push_back(true);
+    bs.append(source.subview(offset, 300));
+    bs.append(source.subview(0, 5));
+    expected = "1" + str.substr(offset, 300) + str.substr(0, 5);
+    CHECK_THAT(bs, bitset_equals_string(expected));
+
+    bs.append(bs.subview(1, 100));
+    expected += expected.substr(1, 100);
+    CHECK_THAT(bs, bitset_equals_string(expected));
+  }
+
+  SECTION("append_word") {
+    bs.append_word(0b101, 3);
+    bs.append_word(~uint64_t(0), 64);
+    bs.append_word(0xff00, 10);
+    bs.append_word(0, 0);
+    expected = "101" + std::string(64, '1') + "1100000000";
+    CHECK_THAT(bs, bitset_equals_string(expected));
+
+    bs >>= 40;
+    bs.append_word(0, 40);
+    expected = expected.substr(0, expected.size() - 40) + std::string(40, '0');
+    CHECK_THAT(bs, bitset_equals_string(expected));
+  }
+
+  SECTION("resize") {
+    bs = bitset(str);
+    bs.resize(100);
+    CHECK_THAT(bs, bitset_equals_string(str.substr(0, 100)));
+
+    bs.resize(300, true);
+    CHECK_THAT(bs, bitset_equals_string(str.substr(0, 100) + std::string(200, '1')));
+
+    bs.resize(50);
+    bs.resize(150);
+    CHECK_THAT(bs, bitset_equals_string(str.substr(0, 50) + std::string(100, '0')));
+  }
+}
+
 TEST_CASE("right shift") {
   SECTION("empty") {
     bitset bs;
@@ -274,6 +346,150 @@ TEST_CASE("bitwise operations") {
   }
 }
 
+TEST_CASE("bitwise operations on temporaries") {
+  std::string_view lhs_str = "11110110111010000100101111101000011011111111000001100110010010001011100100110101"
+                             "10110010011101011000110100101100101100100111010110001101001011001011001001110101";
+  std::string_view rhs_str = "00011110011010000111001101110001001001001101001001001110010010110100110100111111"
+                             "01001101100010110111010011010010010011011000101101110100110100100100110110001011";
+  const bitset rhs(rhs_str);
+
+  bitset lhs(lhs_str);
+  bitset::const_iterator first = std::as_const(lhs).begin();
+
+  SECTION("bitwise and") {
+    bitset result = std::move(lhs) & rhs;
+    CHECK(result == (bitset(lhs_str) & rhs));
+    CHECK(std::as_const(result).begin() == first);
+  }
+
+  SECTION("bitwise or") {
+    bitset result = rhs | std::move(lhs);
+    CHECK(result == (bitset(lhs_str) | rhs));
+    CHECK(std::as_const(result).begin() == first);
+  }
+
+  SECTION("bitwise xor") {
+    bitset result = std::move(lhs) ^ bitset(rhs);
+    CHECK(result == (bitset(lhs_str) ^ rhs));
+    CHECK(std::as_const(result).begin() == first);
+  }
+
+  SECTION("bitwise not") {
+    bitset result = ~std::move(lhs);
+    CHECK(result == ~bitset(lhs_str));
+    CHECK(std::as_const(result).begin() == first);
+  }
+
+  SECTION("chain") {
+    bitset result = ~(std::move(lhs) & rhs) ^ rhs | rhs.subview();
+    CHECK(result == (((~(bitset(lhs_str) & rhs)) ^ rhs) | rhs));
+    CHECK(std::as_const(result).begin() == first);
+  }
+
+  SECTION("different sizes") {
+    bitset result = rhs.subview(0, 10) & std::move(lhs);
+    CHECK_THAT(result, bitset_equals_string("0001011001"));
+  }
+}
+
+TEST_CASE("bitwise expressions") {
+  std::mt19937 rng(13);
+  std::string a_str = random_bit_string(700, rng);
+  std::string b_str = random_bit_string(700, rng);
+  std::string c_str = random_bit_string(700, rng);
+
+  std::size_t offset = GENERATE(0, 3, 64);
+  std::size_t count = GENERATE(0, 1, 63, 64, 200, 600);
+  CAPTURE(offset, count);
+
+  bitset a(a_str);
+  const bitset b(b_str);
+  const bitset c(c_str);
+  bitset::const_view a_view = std::as_const(a).subview(offset, count);
+  bitset::const_view b_view = b.subview(0, count);
+  bitset::const_view c_view = c.subview(offset + 1, count);
+
+  std::string expected(count, '0');
+  for (std::size_t i = 0; i < count; ++i) {
+    bool bit = ((a_str[offset + i] == '1') && (b_str[i] == '1')) || (c_str[offset + 1 + i] == '0');
+    expected[i] = bit ? '1' : '0';
+  }
+
+  auto expr = (a_view & b_view) | ~c_view;
+  STATIC_CHECK_FALSE(std::is_same_v<decltype(expr), bitset>);
+  STATIC_CHECK(std::is_same_v<decltype(bitset(a_str) & b), bitset>);
+
+  SECTION("evaluation") {
+    bitset result = expr;
+    CHECK_THAT(result, bitset_equals_string(expected));
+    CHECK(expr == result);
+    CHECK(result == expr);
+    CHECK_FALSE(expr != result);
+  }
+
+  SECTION("reductions") {
+    std::size_t ones = std::ranges::count(expected, '1');
+    CHECK(expr.size() == count);
+    CHECK(expr.count() == ones);
+    CHECK(expr.any() == (ones != 0));
+    CHECK(expr.all() == (ones == count));
+    CHECK((a_view ^ a_view).count() == 0);
+    CHECK((a_view | ~a_view).all());
+  }
+
+  SECTION("compound assignment") {
+    bitset result(a_view);
+    result ^= expr;
+    std::string xored(count, '0');
+    for (std::size_t i = 0; i < count; ++i) {
+      xored[i] = (a_str[offset + i] != expected[i]) ? '1' : '0';
+    }
+    CHECK_THAT(result, bitset_equals_string(xored));
+  }
+
+  SECTION("operand aliasing the target") {
+    a &= ~a | b;
+    for (std::size_t i = 0; i < a_str.size(); ++i) {
+      a_str[i] = (a_str[i] == '1' && b_str[i] == '1') ? '1' : '0';
+    }
+    CHECK_THAT(a, bitset_equals_string(a_str));
+  }
+
+  SECTION("view target") {
+    a.subview(offset, count) |= a.subview(0, count) & b_view;
+    std::string original = a_str;
+    for (std::size_t i = 0; i < count; ++i) {
+      bool bit = (original[offset + i] == '1') || ((original[i] == '1') && (b_str[i] == '1'));
+      a_str[offset + i] = bit ? '1' : '0';
+    }
+    CHECK_THAT(a, bitset_equals_string(a_str));
+  }
+
+  SECTION("view target without aliasing") {
+    bitset target(a_str);
+    target.subview(offset + 5, count) ^= (a_view & b_view) | ~c_view;
+    for (std::size_t i = 0; i < count; ++i) {
+      a_str[offset + 5 + i] = (a_str[offset + 5 + i] != expected[i]) ? '1' : '0';
+    }
+    CHECK_THAT(target, bitset_equals_string(a_str));
+  }
+
+  SECTION("temporaries") {
+    bitset lhs(b_view);
+    bitset::const_iterator first = std::as_const(lhs).begin();
+    bitset result = std::move(lhs) & (a_view | ~c_view);
+    CHECK(result == (b_view & (a_view | ~c_view)));
+    if (count > 2 * bitset::word_size) {
+      CHECK(std::as_const(result).begin() == first);
+    }
+  }
+
+  SECTION("shifts") {
+    CHECK((expr << 5) == (bitset(expr) << 5));
+    CHECK((expr >> 5) == (bitset(expr) >> 5));
+  }
+}
+
 TEST_CASE("bitset::all/any/count") {
   SECTION("empty") {
     bitset bs;
@@ -309,6 +525,57 @@ TEST_CASE("bitset::all/any/count") {
   }
 }
 
+TEST_CASE("pair reductions") {
+  SECTION("empty") {
+    bitset bs;
+    CHECK(and_count(bs, bs) == 0);
+    CHECK(xor_count(bs, bs) == 0);
+    CHECK_FALSE(intersects(bs, bs));
+    CHECK(is_subset_of(bs, bs));
+    CHECK(jaccard(bs, bs) == 1.0);
+  }
+
+  SECTION("single word") {
+    bitset lhs("1101100");
+    bitset rhs("0101110");
+    CHECK(and_count(lhs, rhs) == 3);
+    CHECK(or_count(lhs, rhs) == 5);
+    CHECK(xor_count(lhs, rhs) == 2);
+    CHECK(andnot_count(lhs, rhs) == 1);
+    CHECK(andnot_count(rhs, lhs) == 1);
+    CHECK(intersects(lhs, rhs));
+    CHECK_FALSE(is_subset_of(lhs, rhs));
+    CHECK(is_subset_of(lhs.subview(1, 4), rhs.subview(1, 4)));
+    CHECK(jaccard(lhs, rhs) == 0.6);
+    CHECK(jaccard(lhs, lhs) == 1.0);
+    CHECK(jaccard(lhs, bitset(~lhs)) == 0.0);
+  }
+
+  SECTION("longer operand") {
+    bitset lhs("101");
+    bitset rhs("1011111");
+    CHECK(lhs.subview().and_count(rhs) == 2);
+    CHECK(lhs.subview().is_subset_of(rhs));
+    CHECK(xor_count(lhs, rhs) == 0);
+  }
+
+  SECTION("same results as expressions") {
+    std::mt19937 rng(29);
+    bitset lhs(random_bit_string(1000, rng));
+    bitset rhs(random_bit_string(1000, rng));
+    for (std::size_t offset : {0, 1, 63, 64, 200}) {
+      auto lhs_view = lhs.subview(offset, 700);
+      auto rhs_view = rhs.subview(300 - offset, 700);
+      CAPTURE(offset);
+      CHECK(and_count(lhs_view, rhs_view) == (lhs_view & rhs_view).count());
+      CHECK(or_count(lhs_view, rhs_view) == (lhs_view | rhs_view).count());
+      CHECK(xor_count(lhs_view, rhs_view) == (lhs_view ^ rhs_view).count());
+      CHECK(andnot_count(lhs_view, rhs_view) == (lhs_view & ~rhs_view).count());
+      CHECK(is_subset_of(lhs_view, rhs_view) == !(lhs_view & ~rhs_view).any());
+    }
+  }
+}
+
 TEST_CASE("bitset comparison") {
   SECTION("empty") {
     bitset bs_1;
@@ -414,6 +681,61 @@ TEST_CASE("chained view operations") {
   CHECK(bs_2 == bitset("1110010101"));
 }
 
+TEST_CASE("long view operations") {
+  std::mt19937 rng(42);
+  std::string lhs_str = random_bit_string(1500, rng);
+  std::string rhs_str = random_bit_string(1500, rng);
+
+  std::size_t lhs_offset = GENERATE(0, 1, 63, 64, 130);
+  std::size_t rhs_offset = GENERATE(0, 5, 64, 127);
+  std::size_t count = GENERATE(0, 70, 1000, 1300);
+  CAPTURE(lhs_offset, rhs_offset, count);
+
+  bitset lhs(lhs_str);
+  const bitset rhs(rhs_str);
+  bitset::view lhs_view = lhs.subview(lhs_offset, count);
+  bitset::const_view rhs_view = rhs.subview(rhs_offset, count);
+
+  auto expected = [&](auto operation) {
+    std::string result = lhs_str;
+    for (std::size_t i = 0; i < count; ++i) {
+      bool bit = operation(lhs_str[lhs_offset + i] == '1', rhs_str[rhs_offset + i] == '1');
+      result[lhs_offset + i] = bit ? '1' : '0';
+    }
+    return result;
+  };
+
+  SECTION("bitwise and") {
+    lhs_view &= rhs_view;
+    CHECK_THAT(lhs, bitset_equals_string(expected([](bool a, bool b) { return a && b; })));
+  }
+
+  SECTION("bitwise or") {
+    lhs_view |= rhs_view;
+    CHECK_THAT(lhs, bitset_equals_string(expected([](bool a, bool b) { return a || b; })));
+  }
+
+  SECTION("bitwise xor") {
+    lhs_view ^= rhs_view;
+    CHECK_THAT(lhs, bitset_equals_string(expected([](bool a, bool b) { return a != b; })));
+  }
+
+  SECTION("flip") {
+    lhs_view.flip();
+    CHECK_THAT(lhs, bitset_equals_string(expected([](bool a, bool) { return !a; })));
+  }
+
+  SECTION("set") {
+    lhs_view.set();
+    CHECK_THAT(lhs, bitset_equals_string(expected([](bool, bool) { return true; })));
+  }
+
+  SECTION("reset") {
+    lhs_view.reset();
+    CHECK_THAT(lhs, bitset_equals_string(expected([](bool, bool) { return false; })));
+  }
+}
+
 TEST_CASE("Anton's mega tests") {
   const bitset zeros_bs = bitset("00000000000000000000");
   const bitset ones_bs = bitset("11111111111111111111");
@@ -0,0 +1,83 @@
+#include "bitset-parallel.h"
+#include "bitset.h"
+#include "test-helpers.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include <cstddef>
+#include <random>
+#include <string>
+#include <utility>
+
+TEST_CASE("parallel operations match sequential ones") {
+  std::size_t threads = GENERATE(1, 4);
+  bitset_executor executor(threads, 1000);
+  CHECK(executor.concurrency() == threads);
+
+  std::mt19937 rng(17);
+  std::string lhs_str = random_bit_string(20000, rng);
+  std::string rhs_str = random_bit_string(20000, rng);
+
+  std::size_t lhs_offset = GENERATE(0, 3, 64);
+  std::size_t rhs_offset = GENERATE(0, 3, 17);
+  std::size_t count = GENERATE(100, 19000);
+  CAPTURE(threads, lhs_offset, rhs_offset, count);
+
+  bitset lhs(lhs_str);
+  bitset rhs(rhs_str);
+  bitset expected(lhs);
+  bitset::view dst = lhs.subview(lhs_offset, count);
+  bitset::const_view src = std::as_const(rhs).subview(rhs_offset, count);
+  bitset::view expected_dst = expected.subview(lhs_offset, count);
+
+  SECTION("bitwise operations") {
+    executor.and_assign(dst, src);
+    expected_dst &= src;
+    CHECK(lhs == expected);
+
+    executor.or_assign(dst, src);
+    expected_dst |= src;
+    CHECK(lhs == expected);
+
+    executor.xor_assign(dst, src);
+    expected_dst ^= src;
+    CHECK(lhs == expected);
+
+    executor.flip(dst);
+    expected_dst.flip();
+    CHECK(lhs == expected);
+  }
+
+  SECTION("reductions") {
+    CHECK(executor.count(dst) == dst.count());
+    CHECK(executor.any(dst));
+    CHECK_FALSE(executor.all(dst));
+    CHECK_FALSE(executor.equal(dst, src));
+    CHECK(executor.equal(dst, expected_dst));
+
+    dst.reset();
+    CHECK_FALSE(executor.any(dst));
+    lhs[lhs_offset + count - 1] = true;
+    CHECK(executor.any(dst));
+    CHECK(executor.count(dst) == 1);
+
+    dst.set();
+    CHECK(executor.all(dst));
+    lhs[lhs_offset + count / 2] = false;
+    CHECK_FALSE(executor.all(dst));
+    CHECK_FALSE(executor.equal(dst, bitset(count, true)));
+  }
+}
+
+TEST_CASE("parallel operations on empty views") {
+  bitset_executor executor(2);
+  bitset bs;
+
+  CHECK(executor.count(bs) == 0);
+  CHECK_FALSE(executor.any(bs));
+  CHECK(executor.all(bs));
+  CHECK(executor.equal(bs, bs));
+  executor.flip(bs);
+  CHECK(bs.empty());
+}
@@ -0,0 +1,76 @@
+#include "bitset-rank-select.h"
+#include "bitset.h"
+#include "test-helpers.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include <cstddef>
+#include <random>
+#include <string>
+#include <vector>
+
+TEST_CASE("rank/select on empty bitset") {
+  bitset bs;
+  rank_select_index index(bs);
+
+  CHECK(index.size() == 0);
+  CHECK(index.count() == 0);
+  CHECK(index.rank1(0) == 0);
+  CHECK(index.rank1(10) == 0);
+  CHECK(index.select1(0) == rank_select_index::npos);
+}
+
+TEST_CASE("rank/select matches naive scan") {
+  std::mt19937 rng(11);
+  std::size_t size = GENERATE(1, 64, 2047, 2048, 5000, 40000);
+  int density = GENERATE(0, 1, 50, 100);
+  std::size_t offset = GENERATE(0, 5);
+  CAPTURE(size, density, offset);
+
+  std::string str(size + offset, '0');
+  std::bernoulli_distribution bit(density / 100.0);
+  for (char& c : str) {
+    c = bit(rng) ? '1' : '0';
+  }
+  bitset bs(str);
+  bitset::const_view view = bs.subview(offset);
+  rank_select_index index(view);
+
+  std::vector<std::size_t> ones;
+  for (std::size_t i = 0; i < size; ++i) {
+    if (str[offset + i] == '1') {
+      ones.push_back(i);
+    }
+  }
+
+  REQUIRE(index.size() == size);
+  REQUIRE(index.count() == ones.size());
+
+  std::size_t rank = 0;
+  for (std::size_t i = 0; i <= size; ++i) {
+    if (i % 97 == 0 || i + 64 > size) {
+      CHECK(index.rank1(i) == rank);
+      CHECK(index.rank0(i) == i - rank);
+    }
+    if (i < size && str[offset + i] == '1') {
+      ++rank;
+    }
+  }
+
+  for (std::size_t k = 0; k < ones.size(); k += 13) {
+    CHECK(index.select1(k) == ones[k]);
+  }
+  if (!ones.empty()) {
+    CHECK(index.select1(ones.size() - 1) == ones.back());
+  }
+  CHECK(index.select1(ones.size()) == rank_select_index::npos);
+}
+
+TEST_CASE("rank/select space overhead") {
+  bitset bs(1 << 20, true);
+  rank_select_index index(bs);
+
+  CHECK(index.memory_usage() * 8 <= bs.size() * 6 / 100);
+  CHECK(index.select1(bs.size() - 1) == bs.size() - 1);
+}
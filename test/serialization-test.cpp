@@ -0,0 +1,141 @@
+#include "bitset-serialization.h"
+#include "bitset.h"
+#include "test-helpers.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include <cstddef>
+#include <cstring>
+#include <random>
+#include <span>
+#include <sstream>
+#include <string>
+#include <vector>
+
+TEST_CASE("bitset binary round trip") {
+  std::size_t size = GENERATE(0, 1, 64, 100, 1000);
+  CAPTURE(size);
+  std::mt19937 rng(37);
+  std::string str = random_bit_string(size, rng);
+
+  bitset bs(str);
+  // Leave stale bits past the end, which must not reach the output.
+  bs <<= 20;
+  bs.subview(size).set();
+  bs >>= 20;
+
+  std::stringstream stream;
+  bs.write(stream);
+  CHECK(stream.str().size() == bitset_format::serialized_bytes(size));
+
+  bitset loaded = bitset::read(stream);
+  CHECK(stream);
+  CHECK_THAT(loaded, bitset_equals_string(str));
+
+  std::string bytes = stream.str();
+  std::vector<uint64_t> buffer(bytes.size() / sizeof(uint64_t));
+  std::memcpy(buffer.data(), bytes.data(), bytes.size());
+  auto view = bitset::from_buffer(std::as_bytes(std::span(buffer)));
+  REQUIRE(view.has_value());
+  CHECK(*view == bs);
+}
+
+TEST_CASE("bitset binary read of many chunks") {
+  std::size_t size = GENERATE(std::size_t(200000) * 64, std::size_t(200000) * 64 + 13);
+  CAPTURE(size);
+  bitset bs(size, false);
+  for (std::size_t i = 0; i < size; i += 997) {
+    bs[i] = true;
+  }
+  std::stringstream stream;
+  bs.write(stream);
+
+  bitset loaded = bitset::read(stream);
+  CHECK(stream);
+  CHECK(loaded.size() == size);
+  CHECK(loaded.capacity() < size + 64);
+  CHECK(loaded == bs);
+}
+
+TEST_CASE("bitset binary format rejects bad input") {
+  bitset bs(std::string(200, '1'));
+  std::stringstream stream;
+  bs.write(stream);
+  std::string bytes = stream.str();
+
+  SECTION("truncated") {
+    std::istringstream in(bytes.substr(0, bytes.size() - 1));
+    bitset loaded = bitset::read(in);
+    CHECK(in.fail());
+    CHECK(loaded.empty());
+  }
+
+  SECTION("corrupted") {
+    bytes.back() ^= 1;
+    std::istringstream in(bytes);
+    CHECK(bitset::read(in).empty());
+    CHECK(in.fail());
+  }
+
+  SECTION("corrupted size") {
+    // Every word is still there, so only the checksum notices.
+    std::size_t size = GENERATE(199, 201, 256);
+    CAPTURE(size);
+    bitset_format::header header;
+    std::memcpy(&header, bytes.data(), sizeof(header));
+    header.size = size;
+    std::memcpy(bytes.data(), &header, sizeof(header));
+
+    std::istringstream in(bytes);
+    CHECK(bitset::read(in).empty());
+    CHECK(in.fail());
+
+    std::vector<uint64_t> buffer(bytes.size() / sizeof(uint64_t));
+    std::memcpy(buffer.data(), bytes.data(), bytes.size());
+    CHECK_FALSE(bitset::from_buffer(std::as_bytes(std::span(buffer))).has_value());
+    CHECK(bitset::from_buffer(std::as_bytes(std::span(buffer)), false).has_value());
+  }
+
+  SECTION("wrong magic") {
+    bytes[0] = 'X';
+    std::istringstream in(bytes);
+    CHECK(bitset::read(in).empty());
+    CHECK(in.fail());
+  }
+
+  SECTION("huge size") {
+    // A size that wraps the word count, one that overflows the view, and one far beyond the data. Without
+    // verification, only the length check stands between them and a view past the buffer.
+    std::size_t size = GENERATE(std::size_t(-11), std::size_t(-1) / 2 + 1, std::size_t(1) << 40);
+    CAPTURE(size);
+    bitset_format::header header = bitset_format::make_header(0, nullptr);
+    header.size = size;
+    CHECK_FALSE(bitset_format::is_complete(header, sizeof(header)));
+    std::memcpy(bytes.data(), &header, sizeof(header));
+
+    std::istringstream in(bytes);
+    CHECK(bitset::read(in).empty());
+    CHECK(in.fail());
+
+    std::vector<uint64_t> buffer(bytes.size() / sizeof(uint64_t));
+    std::memcpy(buffer.data(), bytes.data(), bytes.size());
+    auto all = std::as_bytes(std::span(buffer));
+    CHECK_FALSE(bitset::from_buffer(all, false).has_value());
+    CHECK_FALSE(bitset::from_buffer(all.subspan(0, sizeof(header))).has_value());
+  }
+
+  SECTION("buffers") {
+    std::vector<uint64_t> buffer(bytes.size() / sizeof(uint64_t) + 1);
+    std::memcpy(buffer.data(), bytes.data(), bytes.size());
+    auto all = std::as_bytes(std::span(buffer));
+
+    CHECK(bitset::from_buffer(all).has_value());
+    CHECK_FALSE(bitset::from_buffer(all.subspan(0, bytes.size() - 1)).has_value());
+    CHECK_FALSE(bitset::from_buffer(all.subspan(1, bytes.size())).has_value());
+
+    buffer[5] ^= 1;
+    CHECK_FALSE(bitset::from_buffer(all).has_value());
+    CHECK(bitset::from_buffer(all, false).has_value());
+  }
+}
@@ -0,0 +1,90 @@
+#include "bitset-static.h"
+#include "test-helpers.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include <concepts>
+#include <random>
+#include <sstream>
+#include <string>
+
+namespace {
+
+constexpr static_bitset<100> pattern() {
+  static_bitset<100> bs;
+  for (std::size_t i = 0; i < bs.size(); i += 3) {
+    bs.set(i);
+  }
+  return bs;
+}
+
+} // namespace
+
+static_assert(sizeof(static_bitset<256>) == 32);
+static_assert(pattern().count() == 34);
+static_assert(pattern().find_first() == 0 && pattern().find_next(0) == 3 && pattern().find_next(99) == bitset::npos);
+static_assert(pattern().find_next(100) == bitset::npos && pattern().find_next(bitset::npos) == bitset::npos);
+static_assert(static_bitset<0>().find_next(bitset::npos) == bitset::npos);
+static_assert(static_bitset<100>().set().all() && static_bitset<100>().set().count() == 100);
+static_assert((~static_bitset<70>()).count() == 70);
+static_assert((pattern() & ~pattern()).none());
+static_assert((pattern() | ~pattern()).all());
+static_assert((pattern() ^ pattern()) == static_bitset<100>());
+static_assert(static_bitset<5>("10110").count() == 3 && static_bitset<5>("10110")[2]);
+static_assert(static_bitset<0>().all() && !static_bitset<0>().any());
+
+TEST_CASE("static_bitset matches bitset") {
+  std::mt19937 rng(53);
+  std::string lhs_str = random_bit_string(300, rng);
+  std::string rhs_str = random_bit_string(300, rng);
+  static_bitset<300> lhs(lhs_str);
+  const static_bitset<300> rhs(rhs_str);
+  const bitset lhs_bitset(lhs_str);
+  const bitset rhs_bitset(rhs_str);
+
+  CHECK_THAT(bitset(lhs), bitset_equals_string(lhs_str));
+  CHECK(to_string(lhs) == lhs_str);
+  CHECK(lhs.count() == lhs_bitset.count());
+  CHECK(bitset(lhs & rhs) == bitset(lhs_bitset & rhs_bitset));
+  CHECK(bitset(lhs | rhs) == bitset(lhs_bitset | rhs_bitset));
+  CHECK(bitset(lhs ^ rhs) == bitset(lhs_bitset ^ rhs_bitset));
+  CHECK(bitset(~lhs) == bitset(~lhs_bitset));
+
+  std::size_t expected = lhs_bitset.find_first();
+  for (std::size_t pos = lhs.find_first(); pos != bitset::npos; pos = lhs.find_next(pos)) {
+    CHECK(pos == expected);
+    expected = lhs_bitset.find_next(expected);
+  }
+  CHECK(expected == bitset::npos);
+}
+
+TEST_CASE("static_bitset views") {
+  static_bitset<200> bs;
+  bs.subview(10, 100).set();
+  CHECK(bs.count() == 100);
+  CHECK(bs.subview(10, 100).all());
+  CHECK(bs.find_first() == 10);
+
+  // Views stop at the size, so the tail stays clear.
+  bitset::view(bs).flip();
+  CHECK(bs.count() == 100);
+  CHECK(bs.words()[3] == ~(~uint64_t(0) >> 8));
+
+  // Mixed with bitsets, the lazy operators and view algorithms apply.
+  const bitset ones(200, true);
+  CHECK(bitset(bs & ones).count() == 100);
+  CHECK((bs & ones) == bs);
+  CHECK(bitset::const_view(bs) == bitset(bs));
+
+  // A temporary static bitset is evaluated at once, since an expression would outlive it.
+  auto result = static_bitset<200>(std::string(200, '1')) & bitset::const_view(bs);
+  STATIC_CHECK(std::same_as<decltype(result), bitset>);
+  CHECK(result == bitset(bs));
+  CHECK((ones ^ static_bitset<200>()).count() == 200);
+  CHECK((bitset(200, false) | static_bitset<200>(std::string(200, '1'))).all());
+
+  std::stringstream stream;
+  stream << bs;
+  CHECK(stream.str() == to_string(bitset(bs)));
+}
@@ -0,0 +1,99 @@
+#include "bitset-stats.h"
+#include "bitset.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <vector>
+
+namespace {
+
+void collect(const bitset_stats::span_event& event, void* context) {
+  static_cast<std::vector<bitset_stats::span_event>*>(context)->push_back(event);
+}
+
+} // namespace
+
+TEST_CASE("stats counters") {
+  bitset_stats::reset();
+  bitset lhs(1000, true);
+  const bitset rhs(1000, false);
+  lhs.subview(0, 640) &= rhs.subview(0, 640);
+  lhs.subview(3, 640) ^= rhs.subview(0, 640);
+  [[maybe_unused]] std::size_t count = lhs.count();
+  bitset_stats::snapshot stats = bitset_stats::current();
+
+  if constexpr (bitset_stats::enabled) {
+    CHECK(stats[bitset_stats::operation::construct].calls == 2);
+    CHECK(stats[bitset_stats::operation::construct].bits == 2000);
+    CHECK(stats[bitset_stats::operation::and_assign].calls == 1);
+    CHECK(stats[bitset_stats::operation::and_assign].words == 10);
+    CHECK(stats[bitset_stats::operation::xor_assign].bits == 640);
+    CHECK(stats[bitset_stats::operation::xor_assign].words == 11);
+    CHECK(stats[bitset_stats::operation::count].calls == 1);
+    CHECK(stats.aligned == 1);
+    CHECK(stats.misaligned == 1);
+    CHECK(stats.allocations == 2);
+    CHECK(stats.allocated_bytes == 2 * 16 * sizeof(bitset::word_type));
+
+    bitset_stats::reset();
+    CHECK(bitset_stats::current()[bitset_stats::operation::construct].calls == 0);
+  } else {
+    CHECK(stats[bitset_stats::operation::construct].calls == 0);
+    CHECK(stats.allocations == 0);
+  }
+}
+
+TEST_CASE("stats of expressions assigned to views") {
+  bitset lhs(1000, true);
+  const bitset a(1000, false);
+  const bitset b(1000, true);
+  bitset_stats::reset();
+  lhs.subview(3, 900) &= a.subview(7, 900) | ~b.subview(0, 900);
+  std::size_t separate = bitset_stats::current().allocations;
+  lhs.subview(3, 900) ^= lhs.subview(0, 900) & b.subview(0, 900);
+  std::size_t aliased = bitset_stats::current().allocations;
+
+  CHECK(separate == 0);
+  if constexpr (bitset_stats::enabled) {
+    CHECK(aliased == 1);
+  }
+}
+
+TEST_CASE("stats count words of the operand's type") {
+  bitset wide(200, true);
+  bitset32 narrow(200, true);
+  bitset_stats::reset();
+  [[maybe_unused]] std::size_t count = wide.subview(60, 8).count() + narrow.subview(60, 8).count() + narrow.count();
+  [[maybe_unused]] bitset copy(wide.subview(1, 64));
+
+  if constexpr (bitset_stats::enabled) {
+    bitset_stats::snapshot stats = bitset_stats::current();
+    CHECK(stats[bitset_stats::operation::count].calls == 3);
+    CHECK(stats[bitset_stats::operation::count].words == 2 + 2 + 7);
+    CHECK(stats[bitset_stats::operation::copy].words == 2);
+  }
+}
+
+TEST_CASE("stats tracing") {
+  std::vector<bitset_stats::span_event> events;
+  bitset_stats::set_trace(collect, &events);
+  bitset bs(100, false);
+  bs.flip();
+  bitset_stats::set_trace(nullptr);
+  bs.flip();
+
+  if constexpr (bitset_stats::enabled) {
+    REQUIRE(events.size() == 2);
+    CHECK(events[0].op == bitset_stats::operation::construct);
+    CHECK(events[1].op == bitset_stats::operation::flip);
+    CHECK(events[1].bits == 100);
+    CHECK(events[1].duration.count() >= 0);
+  } else {
+    CHECK(events.empty());
+  }
+}
+
+TEST_CASE("stats operation names") {
+  CHECK(bitset_stats::to_string(bitset_stats::operation::and_assign) == "and_assign");
+  CHECK(bitset_stats::to_string(bitset_stats::operation::to_string) == "to_string");
+}
@@ -7,6 +7,17 @@ std::vector<bool> string_to_bools(std::string_view str) {
   return {view.begin(), view.end()};
 }
 
+std::string random_bit_string(std::size_t size, std::mt19937& rng) {
+  std::bernoulli_distribution bit;
+  std::string result(size, '0');
+  for (char& c : result) {
+    if (bit(rng)) {
+      c = '1';
+    }
+  }
+  return result;
+}
+
 bitset_equals_string::bitset_equals_string(std::string_view expected)
     : _expected(expected) {}
 
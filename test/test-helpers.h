@@ -4,10 +4,14 @@
 
 #include <catch2/matchers/catch_matchers.hpp>
 
+#include <random>
+#include <string>
 #include <vector>
 
 std::vector<bool> string_to_bools(std::string_view str);
 
+std::string random_bit_string(std::size_t size, std::mt19937& rng);
+
 struct bitset_equals_string : Catch::Matchers::MatcherBase<bitset> {
   explicit bitset_equals_string(std::string_view expected);
 
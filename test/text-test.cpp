@@ -0,0 +1,126 @@
+#include "bitset.h"
+#include "test-helpers.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include <random>
+#include <sstream>
+#include <string>
+
+namespace {
+
+// The bits of the bytes of `str`, most significant first.
+std::string bits_of(std::string_view str) {
+  std::string bits;
+  for (char c : str) {
+    for (int bit = 7; bit >= 0; --bit) {
+      bits += ((uint8_t(c) >> bit) & 1) ? '1' : '0';
+    }
+  }
+  return bits;
+}
+
+} // namespace
+
+TEST_CASE("binary text round trip") {
+  std::size_t size = GENERATE(0, 1, 7, 8, 63, 64, 65, 1000, 5000);
+  std::size_t offset = GENERATE(0, 3, 64);
+  CAPTURE(size, offset);
+  std::mt19937 rng(41);
+  std::string str = random_bit_string(size + offset, rng);
+
+  bitset bs(str);
+  CHECK_THAT(bs, bitset_equals_string(str));
+  CHECK(to_string(bs) == str);
+
+  bitset::const_view view = bs.subview(offset);
+  CHECK(to_string(view) == str.substr(offset));
+  std::stringstream stream;
+  stream << view;
+  CHECK(stream.str() == str.substr(offset));
+}
+
+TEST_CASE("bitset constructor reads other characters as zero") {
+  CHECK_THAT(bitset("1x0y1z01a1b1c1d1e"), bitset_equals_string("10001001010101010"));
+}
+
+TEST_CASE("from_string") {
+  std::string str = "0110100111010010011101001000111101001101";
+  auto bs = from_string(str);
+  REQUIRE(bs.has_value());
+  CHECK_THAT(*bs, bitset_equals_string(str));
+  CHECK(from_string("").has_value());
+
+  std::size_t pos = GENERATE(0, 5, 8, 39);
+  std::string bad = str;
+  bad[pos] = GENERATE('2', ' ', 'a', '\0', '\xb1');
+  CHECK_FALSE(from_string(bad).has_value());
+}
+
+TEST_CASE("hex") {
+  bitset bs("0001001000111010111111");
+  CHECK(to_hex(bs) == "123afc");
+  CHECK(to_hex(bitset()) == "");
+
+  auto parsed = from_hex("123aFc", 22);
+  REQUIRE(parsed.has_value());
+  CHECK(*parsed == bs);
+  CHECK(from_hex("123afc")->size() == 24);
+
+  CHECK_FALSE(from_hex("123afc", 20).has_value());
+  CHECK_FALSE(from_hex("123afc", 25).has_value());
+  CHECK_FALSE(from_hex("123agc").has_value());
+  CHECK_FALSE(from_hex("0x12").has_value());
+}
+
+TEST_CASE("hex round trip") {
+  std::size_t size = GENERATE(0, 1, 4, 63, 64, 65, 1000);
+  CAPTURE(size);
+  std::mt19937 rng(43);
+  bitset bs(random_bit_string(size + 5, rng));
+  bitset::const_view view = bs.subview(5);
+
+  std::string hex = to_hex(view);
+  CHECK(hex.size() == (size + 3) / 4);
+  auto parsed = from_hex(hex, size);
+  REQUIRE(parsed.has_value());
+  CHECK(*parsed == view);
+}
+
+TEST_CASE("base64") {
+  // RFC 4648 test vectors.
+  for (std::string_view str : {"", "f", "fo", "foo", "foob", "fooba", "foobar"}) {
+    CAPTURE(str);
+    bitset bs(bits_of(str));
+    std::string encoded = to_base64(bs);
+    auto decoded = from_base64(encoded);
+    REQUIRE(decoded.has_value());
+    CHECK(*decoded == bs);
+  }
+  CHECK(to_base64(bitset(bits_of("foobar"))) == "Zm9vYmFy");
+  CHECK(to_base64(bitset(bits_of("fooba"))) == "Zm9vYmE=");
+  CHECK(to_base64(bitset(bits_of("foob"))) == "Zm9vYg==");
+
+  auto trimmed = from_base64("Zm9vYg==", 27);
+  REQUIRE(trimmed.has_value());
+  CHECK_THAT(*trimmed, bitset_equals_string(bits_of("foob").substr(0, 27)));
+
+  CHECK_FALSE(from_base64("Zm9vYg=").has_value());
+  CHECK_FALSE(from_base64("Zm9vY===").has_value());
+  CHECK_FALSE(from_base64("Zm=vYg==").has_value());
+  CHECK_FALSE(from_base64("Zm9v-g==").has_value());
+  CHECK_FALSE(from_base64("Zm9vYg==", 24).has_value());
+}
+
+TEST_CASE("base64 round trip") {
+  std::size_t size = GENERATE(1, 8, 23, 24, 64, 65, 1000);
+  CAPTURE(size);
+  std::mt19937 rng(47);
+  bitset bs(random_bit_string(size + 3, rng));
+  bitset::const_view view = bs.subview(3);
+
+  auto parsed = from_base64(to_base64(view), size);
+  REQUIRE(parsed.has_value());
+  CHECK(*parsed == view);
+}
@@ -0,0 +1,171 @@
+#include "test-helpers.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <concepts>
+#include <random>
+#include <sstream>
+#include <string>
+#include <utility>
+
+namespace {
+
+template <typename W>
+void check_views(std::size_t seed) {
+  std::mt19937 rng(seed);
+  std::string lhs_str = random_bit_string(700, rng);
+  std::string rhs_str = random_bit_string(700, rng);
+  basic_bitset<W> lhs(lhs_str);
+  const basic_bitset<W> rhs(rhs_str);
+  bitset expected_lhs(lhs_str);
+  const bitset expected_rhs(rhs_str);
+
+  for (std::size_t offset : {0, 1, 31, 64, 100}) {
+    for (std::size_t other_offset : {0, 3, 64, 127}) {
+      std::size_t count = 700 - std::max(offset, other_offset);
+      lhs.subview(offset, count) ^= rhs.subview(other_offset, count);
+      expected_lhs.subview(offset, count) ^= expected_rhs.subview(other_offset, count);
+      lhs.subview(offset, count / 2) |= rhs.subview(other_offset, count / 2);
+      expected_lhs.subview(offset, count / 2) |= expected_rhs.subview(other_offset, count / 2);
+      lhs.subview(offset + 5, count / 3) &= rhs.subview(other_offset, count / 3);
+      expected_lhs.subview(offset + 5, count / 3) &= expected_rhs.subview(other_offset, count / 3);
+      REQUIRE(to_string(lhs) == to_string(expected_lhs));
+      CHECK((lhs.subview(offset, count) == rhs.subview(other_offset, count)) ==
+            (expected_lhs.subview(offset, count) == expected_rhs.subview(other_offset, count)));
+    }
+    lhs.subview(offset, 300).flip();
+    expected_lhs.subview(offset, 300).flip();
+    REQUIRE(to_string(lhs) == to_string(expected_lhs));
+    CHECK(lhs.subview(offset).count() == expected_lhs.subview(offset).count());
+    CHECK(lhs.subview(offset, 200).set().all());
+    CHECK(lhs.subview(offset, 200).find_first_zero() == bitset::npos);
+    CHECK(!lhs.subview(offset + 50, 250).reset().any());
+    expected_lhs.subview(offset, 200).set();
+    expected_lhs.subview(offset + 50, 250).reset();
+  }
+
+  for (std::size_t offset : {0, 1, 64, 127}) {
+    auto view = lhs.subview(offset, 500);
+    auto expected_view = expected_lhs.subview(offset, 500);
+    CHECK(view.and_count(rhs.subview(100)) == expected_view.and_count(expected_rhs.subview(100)));
+    CHECK(view.or_count(rhs.subview(64)) == expected_view.or_count(expected_rhs.subview(64)));
+    CHECK(view.xor_count(rhs.subview(3)) == expected_view.xor_count(expected_rhs.subview(3)));
+    CHECK(view.andnot_count(rhs.subview(offset)) == expected_view.andnot_count(expected_rhs.subview(offset)));
+    CHECK(view.intersects(rhs.subview(7)) == expected_view.intersects(expected_rhs.subview(7)));
+    CHECK(view.is_subset_of(lhs.subview(offset)));
+  }
+
+  basic_bitset<W> copy = lhs;
+  CHECK(copy.subview(1) == lhs.subview(1));
+  for (std::size_t pos : {0, 1, 63, 64, 127, 128, 500, 699}) {
+    CHECK(lhs.find_next(pos) == expected_lhs.find_next(pos));
+    CHECK(lhs.find_prev(pos) == expected_lhs.find_prev(pos));
+    CHECK(lhs.find_next_zero(pos) == expected_lhs.find_next_zero(pos));
+    CHECK(lhs.find_prev_zero(pos) == expected_lhs.find_prev_zero(pos));
+  }
+}
+
+template <typename W>
+void check_growth(std::size_t seed) {
+  std::mt19937 rng(seed);
+  std::string str = random_bit_string(333, rng);
+  basic_bitset<W> bs;
+  for (char c : str.substr(0, 100)) {
+    bs.push_back(c == '1');
+  }
+  bs.append(basic_bitset<W>(str.substr(100, 150)));
+  for (std::size_t i = 250; i < str.size(); i += 20) {
+    std::size_t count = std::min<std::size_t>(20, str.size() - i);
+    W word = bitset_text::parse_word<W>(str.data() + i, count);
+    bs.append_word(word >> (basic_bitset<W>::word_size - count), count);
+  }
+  CHECK(to_string(bs) == str);
+
+  std::ostringstream out;
+  out << bs;
+  CHECK(out.str() == str);
+
+  bs.resize(400, true);
+  CHECK(bs.count() == bitset(str).count() + 67);
+  bs >>= 390;
+  bs <<= 10;
+  CHECK(to_string(bs) == str.substr(0, 10) + std::string(10, '0'));
+}
+
+template <typename W>
+void check_operators(std::size_t seed) {
+  std::mt19937 rng(seed);
+  std::string lhs_str = random_bit_string(300, rng);
+  std::string rhs_str = random_bit_string(300, rng);
+  const basic_bitset<W> lhs(lhs_str);
+  basic_bitset<W> rhs(rhs_str);
+  const bitset expected_lhs(lhs_str);
+  const bitset expected_rhs(rhs_str);
+
+  CHECK(lhs == basic_bitset<W>(lhs_str));
+  CHECK(lhs != rhs);
+  CHECK(lhs.subview(1) != lhs);
+  CHECK(lhs.subview(5, 100) == basic_bitset<W>(lhs_str.substr(5, 100)));
+
+  static_assert(std::same_as<decltype(lhs & rhs), basic_bitset<W>>);
+  CHECK(to_string(lhs & rhs) == to_string(bitset(expected_lhs & expected_rhs)));
+  CHECK(to_string(lhs | rhs.subview()) == to_string(bitset(expected_lhs | expected_rhs)));
+  CHECK(to_string(lhs.subview() ^ rhs) == to_string(bitset(expected_lhs ^ expected_rhs)));
+  CHECK(to_string(~lhs) == to_string(bitset(~expected_lhs)));
+  CHECK(to_string(~lhs.subview(10, 20)) == to_string(bitset(~expected_lhs.subview(10, 20))));
+  CHECK(to_string(lhs << 70) == to_string(expected_lhs << 70));
+  CHECK(to_string(lhs.subview(3) >> 70) == to_string(expected_lhs.subview(3) >> 70));
+  CHECK(((lhs & rhs) | (lhs ^ rhs)) == (lhs | rhs));
+
+  basic_bitset<W> temporary = basic_bitset<W>(lhs) & rhs;
+  CHECK(temporary == (lhs & rhs));
+  CHECK((~std::move(temporary)) == ~(lhs & rhs));
+}
+
+} // namespace
+
+static_assert(bitset32::word_size == 32 && bitset::word_size == 64 && bitset128::word_size == 128);
+static_assert(bitset32::view::word_size == 32 && bitset128::const_iterator::word_size == 128);
+static_assert(std::is_same_v<bitset, basic_bitset<uint64_t>>);
+
+TEST_CASE("32-bit words match bitset") {
+  check_views<uint32_t>(71);
+  check_growth<uint32_t>(72);
+  check_operators<uint32_t>(76);
+}
+
+TEST_CASE("128-bit words match bitset") {
+  check_views<bitset_word::uint128>(73);
+  check_growth<bitset_word::uint128>(74);
+  check_operators<bitset_word::uint128>(77);
+}
+
+TEST_CASE("word helpers") {
+  bitset_word::uint128 word = bitset_word::uint128(1) << 100 | 5;
+  CHECK(bitset_word::popcount(word) == 3);
+  CHECK(bitset_word::countl_zero(word) == 27);
+  CHECK(bitset_word::countr_zero(word) == 0);
+  CHECK(bitset_word::countr_zero(word - 5) == 100);
+  CHECK(bitset_word::countl_zero(uint32_t(1)) == 31);
+}
+
+TEST_CASE("128-bit words on every backend") {
+  std::mt19937 rng(75);
+  std::string str = random_bit_string(2000, rng);
+  for (bitset_simd::backend value :
+       {bitset_simd::backend::scalar, bitset_simd::backend::simd128, bitset_simd::backend::avx2,
+        bitset_simd::backend::avx512}) {
+    if (!bitset_simd::select_backend(value)) {
+      continue;
+    }
+    bitset128 bs(str);
+    CHECK(bs.count() == bitset(str).count());
+    CHECK(bs.find_first() == bitset(str).find_first());
+    CHECK(bs.find_last_zero() == bitset(str).find_last_zero());
+    bs.subview(128, 1500) ^= bitset128(str).subview(128, 1500);
+    CHECK(!bs.subview(128, 1500).any());
+    CHECK(bs.subview(0, 128) == bitset128(str).subview(0, 128));
+  }
+  bitset_simd::select_backend(bitset_simd::best_backend());
+}